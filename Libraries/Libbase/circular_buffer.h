@@ -0,0 +1,184 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __circular_buffer_h
+#define __circular_buffer_h
+
+#include "config.h"
+#include "vector.h"
+
+namespace libbase {
+
+/*!
+ * \brief   Circular Buffer with contiguous views.
+ * \author  Johann Briffa
+ *
+ * A FIFO sequence of elements, where elements are appended at the end and
+ * consumed from the front. Storage is circular, with every element written
+ * twice: at its position and again one capacity further on. This way, any
+ * segment of the buffer contents is contiguous in memory, and can be
+ * returned as an indirect_vector without copying.
+ *
+ * Consuming elements never moves data; storage is only reallocated when the
+ * contents outgrow the current capacity, which grows geometrically, so that
+ * a buffer used for a stream of similar-sized blocks soon stops reallocating.
+ *
+ * \note Views returned by segment() are invalidated by any later call to
+ * push_back() that needs to increase capacity.
+ */
+
+template <class T>
+class circular_buffer {
+private:
+   /*! \name Internal representation */
+   vector<T> m_data; //!< Storage, holding two copies of the circular buffer
+   int m_capacity; //!< Number of elements that can be held
+   int m_start; //!< Storage index of first element, in [0, m_capacity)
+   int m_size; //!< Number of elements held
+   // @}
+protected:
+   //! Verifies that object is in a valid state
+   void test_invariant() const
+      {
+      assert(m_data.size() == 2 * m_capacity);
+      assert(m_start >= 0 && (m_start < m_capacity || m_capacity == 0));
+      assert(m_size >= 0 && m_size <= m_capacity);
+      }
+   //! Writes element 'x' at position 'i' of the circular buffer (both copies)
+   void put(const int i, const T& x)
+      {
+      const int k = (m_start + i) % m_capacity;
+      m_data(k) = x;
+      m_data(k + m_capacity) = x;
+      }
+public:
+   /*! \name Constructors / Destructors */
+   //! Default constructor, with space for 'n' elements
+   explicit circular_buffer(const int n = 0) :
+      m_capacity(0), m_start(0), m_size(0)
+      {
+      reserve(n);
+      }
+   // @}
+
+   /*! \name Resizing operations */
+   /*! \brief Make sure there is space for at least 'n' elements
+    * Existing contents are kept; if storage needs to grow, the first element
+    * is moved to the start of storage.
+    */
+   void reserve(const int n)
+      {
+      test_invariant();
+      if (n <= m_capacity)
+         return;
+      // keep a copy of existing contents
+      vector<T> contents(m_size);
+      for (int i = 0; i < m_size; i++)
+         contents(i) = (*this)(i);
+      // reallocate and restore contents
+      m_data.init(2 * n);
+      m_capacity = n;
+      m_start = 0;
+      for (int i = 0; i < m_size; i++)
+         put(i, contents(i));
+      test_invariant();
+      }
+   //! Discard all contents (keeps the allocated storage)
+   void clear()
+      {
+      m_start = 0;
+      m_size = 0;
+      }
+   // @}
+
+   /*! \name Stream operations */
+   //! Append the given sequence at the end
+   void push_back(const vector<T>& x)
+      {
+      test_invariant();
+      const int n = x.size();
+      if (m_size + n > m_capacity)
+         reserve(std::max(2 * m_capacity, m_size + n));
+      for (int i = 0; i < n; i++)
+         put(m_size + i, x(i));
+      m_size += n;
+      test_invariant();
+      }
+   //! Append 'n' copies of the given value at the end
+   void push_back(const int n, const T& x)
+      {
+      test_invariant();
+      assert(n >= 0);
+      if (m_size + n > m_capacity)
+         reserve(std::max(2 * m_capacity, m_size + n));
+      for (int i = 0; i < n; i++)
+         put(m_size + i, x);
+      m_size += n;
+      test_invariant();
+      }
+   //! Consume 'n' elements from the front
+   void pop_front(const int n)
+      {
+      test_invariant();
+      assert(n >= 0 && n <= m_size);
+      m_size -= n;
+      m_start = (m_size == 0) ? 0 : (m_start + n) % m_capacity;
+      test_invariant();
+      }
+   // @}
+
+   /*! \name Element access */
+   /*! \brief Index operator (read-only access)
+    * \note Performs boundary checking.
+    */
+   const T& operator()(const int i) const
+      {
+      assert(i >= 0 && i < m_size);
+      return m_data(m_start + i);
+      }
+   /*! \brief Contiguous view of 'n' elements, starting at position 'start'
+    * \note This is a shallow reference to the buffer contents.
+    */
+   indirect_vector<T> segment(const int start, const int n)
+      {
+      test_invariant();
+      assert(start >= 0 && n >= 0 && start + n <= m_size);
+      return m_data.segment(m_start + start, n);
+      }
+   // @}
+
+   /*! \name Information functions */
+   //! Number of elements held
+   int size() const
+      {
+      return m_size;
+      }
+   //! Number of elements that can be held without reallocation
+   int capacity() const
+      {
+      return m_capacity;
+      }
+   // @}
+};
+
+} // end namespace
+
+#endif
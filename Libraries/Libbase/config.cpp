@@ -47,6 +47,9 @@
 #include <csignal>
 #include <cstdio>
 #include <sstream>
+#ifdef USE_OMP
+#  include <omp.h>
+#endif
 
 namespace libbase {
 
@@ -236,6 +239,34 @@ std::string getlasterror()
    return sout.str();
    }
 
+// Parallel execution support
+
+/*! \brief Number of threads available for parallel regions
+ * This is the number of threads that the next parallel region will use,
+ * and is therefore suitable for allocating per-thread working objects.
+ */
+int getthreadcount()
+   {
+#ifdef USE_OMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+   }
+
+/*! \brief Index of the calling thread within the current parallel region
+ * The returned value is in [0, getthreadcount() - 1], and is always zero
+ * outside a parallel region.
+ */
+int getthreadid()
+   {
+#ifdef USE_OMP
+   return omp_get_thread_num();
+#else
+   return 0;
+#endif
+   }
+
 //! Function to skip over whitespace
 
 std::istream& eatwhite(std::istream& is)
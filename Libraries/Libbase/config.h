@@ -281,6 +281,10 @@ bool interrupted(void);
 // System error message reporting
 std::string getlasterror();
 
+// Parallel execution support (single-threaded unless built with OpenMP)
+int getthreadcount();
+int getthreadid();
+
 // Functions to skip over whitespace and comments
 std::istream& eatwhite(std::istream& is);
 std::istream& eatcomments(std::istream& is);
@@ -76,7 +76,7 @@ public:
       BigInteger randomness;
       randomness.random(grp.get_q().size());
 
-      BigInteger gr = grp.get_g().pow_mod(randomness, grp.get_p());
+      BigInteger gr = grp.pow_g(randomness);
       BigInteger myr = (pubKey.pow_mod(randomness, grp.get_p()) * plainText)
             % grp.get_p();
       return ciphertext<BigInteger> (gr, myr);
@@ -27,12 +27,20 @@
 #include "keygenerator.h"
 #include "sha.h"
 
+#include <vector>
+#include <algorithm>
+
 namespace libbase {
 
 /*!
  * \brief   Log-domain comparison
  * \author  Johann Briffa
  *
+ * Powers of the group generator use the group's fixed-base table; each
+ * verification equation is checked with a single simultaneous
+ * exponentiation. Many proofs can be checked together with a batch test,
+ * which is split across threads.
+ *
  * The class takes a BigInteger template parameter.
  */
 
@@ -75,11 +83,12 @@ public:
    static equalitydisclog_zpschnorr constructProof(group<BigInteger> grp,
          BigInteger g1, BigInteger g2, BigInteger x)
       {
-      BigInteger v = g1.pow_mod(x, grp.get_p());
+      const bool g1_is_g = (g1 == grp.get_g());
+      BigInteger v = g1_is_g ? grp.pow_g(x) : g1.pow_mod(x, grp.get_p());
       BigInteger w = g2.pow_mod(x, grp.get_p());
       BigInteger z = group<BigInteger>::get_random_integer(grp.get_q());
 
-      BigInteger a = g1.pow_mod(z, grp.get_p());
+      BigInteger a = g1_is_g ? grp.pow_g(z) : g1.pow_mod(z, grp.get_p());
       BigInteger b = g2.pow_mod(z, grp.get_p());
 
       std::vector<unsigned char> buf;
@@ -109,17 +118,88 @@ public:
     *      r = (z + cx) mod q
     *
     * To verify, check that g_1^r = av^c (mod p) and g_2^r = bw^c (mod p).
+    * These are checked in the equivalent form g_1^r (v^-1)^c = a (mod p),
+    * so that each side needs one simultaneous exponentiation.
     */
    static bool verify(group<BigInteger> grp, equalitydisclog_zpschnorr E)
       {
-      const BigInteger lhs1 = E.g1.pow_mod(E.r, grp.get_p());
-      const BigInteger lhs2 = E.g2.pow_mod(E.r, grp.get_p());
-      const BigInteger rhs1 = (E.v.pow_mod(E.c, grp.get_p()) * E.a)
-            % grp.get_p();
-      const BigInteger rhs2 = (E.w.pow_mod(E.c, grp.get_p()) * E.b)
-            % grp.get_p();
-
-      return lhs1 == rhs1 && lhs2 == rhs2;
+      const BigInteger& p = grp.get_p();
+      // v and w must be invertible; otherwise av^c = 0 (mod p), which can
+      // never match a power of g_1 or g_2
+      if (E.v % p == BigInteger(0) || E.w % p == BigInteger(0))
+         return false;
+      std::vector<BigInteger> base(2), exp(2);
+      exp[0] = E.r;
+      exp[1] = E.c;
+      base[0] = E.g1;
+      base[1] = E.v.inv_mod(p);
+      const BigInteger lhs1 = BigInteger::multi_pow_mod(base, exp, p);
+      base[0] = E.g2;
+      base[1] = E.w.inv_mod(p);
+      const BigInteger lhs2 = BigInteger::multi_pow_mod(base, exp, p);
+
+      return lhs1 == E.a % p && lhs2 == E.b % p;
+      }
+
+   /* \brief Batch proof verification
+    *
+    * For random 'bits'-bit weights d_i and e_i, check that
+    *      prod g_1i^(d_i r_i) g_2i^(e_i r_i)
+    *         = prod a_i^(d_i) v_i^(d_i c_i) b_i^(e_i) w_i^(e_i c_i) (mod p)
+    * with both sides computed by simultaneous exponentiation. If all proofs
+    * are valid this always holds; otherwise it fails except with
+    * probability about 2^-bits, assuming the proof elements lie in the
+    * subgroup of order q. The proofs are split into one batch per thread.
+    *
+    * Returns true only if all proofs are valid; use verify() to find the
+    * invalid proofs in a failed batch.
+    */
+   static bool verify(group<BigInteger> grp,
+         const std::vector<equalitydisclog_zpschnorr>& proofs,
+         const int bits = 64)
+      {
+      const int n = proofs.size();
+      if (n == 0)
+         return true;
+      // draw weights sequentially, as the generator is shared
+      std::vector<BigInteger> d(n), e(n);
+      for (int i = 0; i < n; i++)
+         {
+         d[i].random(bits);
+         e[i].random(bits);
+         }
+      // check each batch
+      const int batches = std::min(n, getthreadcount());
+      std::vector<int> ok(batches);
+#pragma omp parallel for schedule(dynamic)
+      for (int k = 0; k < batches; k++)
+         {
+         const int i0 = int(libbase::int64s(n) * k / batches);
+         const int i1 = int(libbase::int64s(n) * (k + 1) / batches);
+         std::vector<BigInteger> lbase, lexp, rbase, rexp;
+         for (int i = i0; i < i1; i++)
+            {
+            const equalitydisclog_zpschnorr& E = proofs[i];
+            lbase.push_back(E.g1);
+            lexp.push_back(d[i] * E.r);
+            lbase.push_back(E.g2);
+            lexp.push_back(e[i] * E.r);
+            rbase.push_back(E.a);
+            rexp.push_back(d[i]);
+            rbase.push_back(E.v);
+            rexp.push_back(d[i] * E.c);
+            rbase.push_back(E.b);
+            rexp.push_back(e[i]);
+            rbase.push_back(E.w);
+            rexp.push_back(e[i] * E.c);
+            }
+         ok[k] = BigInteger::multi_pow_mod(lbase, lexp, grp.get_p())
+               == BigInteger::multi_pow_mod(rbase, rexp, grp.get_p());
+         }
+      for (int k = 0; k < batches; k++)
+         if (!ok[k])
+            return false;
+      return true;
       }
 };
 
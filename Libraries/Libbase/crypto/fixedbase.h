@@ -0,0 +1,129 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __fixedbase_h
+#define __fixedbase_h
+
+#include "config.h"
+
+#include <vector>
+
+namespace libbase {
+
+/*!
+ * \brief   Fixed-base exponentiation.
+ * \author  Johann Briffa
+ *
+ * Computes powers of a fixed base g modulo m, for exponents up to a given
+ * bit length, using a precomputed table of g^(d.2^(wj)) for every w-bit
+ * digit d and window position j. An exponentiation then needs one modular
+ * multiplication per non-zero window of the exponent and no squarings.
+ * Exponents that are negative or too long for the table are passed on to
+ * the usual pow_mod().
+ *
+ * The class takes a BigInteger template parameter.
+ */
+
+template <class BigInteger>
+class fixedbase {
+private:
+   /*! \name Internal representation */
+   int w; //!< Window width in bits
+   int windows; //!< Number of windows covered by the table
+   BigInteger g; //!< Base
+   BigInteger m; //!< Modulus
+   std::vector<BigInteger> table; //!< Entry [j.2^w + d] is g^(d.2^(wj)) mod m
+   // @}
+
+public:
+   /*! \name Constructors / Destructors */
+   //! Default constructor
+   fixedbase() :
+      w(0), windows(0)
+      {
+      }
+   //! Principal constructor
+   fixedbase(const BigInteger& g, const BigInteger& m, const int bits,
+         const int w = 4)
+      {
+      init(g, m, bits, w);
+      }
+   // @}
+
+   /*! \brief Set up table for base 'g' modulo 'm'
+    * \param bits Length of the longest exponent to be handled by the table
+    * \param w Window width; the table holds ceil(bits/w).2^w entries
+    */
+   void init(const BigInteger& g, const BigInteger& m, const int bits,
+         const int w = 4)
+      {
+      assertalways(bits >= 0);
+      assertalways(w >= 1 && w <= 8);
+      this->w = w;
+      this->windows = (bits + w - 1) / w;
+      this->g = g;
+      this->m = m;
+      const int entries = 1 << w;
+      table.assign(windows * entries, BigInteger(1) % m);
+      // base for the current window, g^(2^(wj))
+      BigInteger b = g % m;
+      for (int j = 0; j < windows; j++)
+         {
+         BigInteger* t = &table[j * entries];
+         for (int d = 1; d < entries; d++)
+            t[d] = (t[d - 1] * b) % m;
+         b = (t[entries - 1] * b) % m;
+         }
+      }
+
+   //! Compute g^e mod m
+   BigInteger pow_mod(const BigInteger& e) const
+      {
+      if (e < BigInteger(0) || int(e.size()) > windows * w)
+         return g.pow_mod(e, m);
+      BigInteger r = BigInteger(1) % m;
+      const int entries = 1 << w;
+      for (int j = 0; j < windows; j++)
+         {
+         int d = 0;
+         for (int k = w - 1; k >= 0; k--)
+            d = (d << 1) | int(e.test_bit(j * w + k));
+         if (d != 0)
+            r = (r * table[j * entries + d]) % m;
+         }
+      return r;
+      }
+
+   /*! \name Getters */
+   const BigInteger& get_base() const
+      {
+      return g;
+      }
+   const BigInteger& get_modulus() const
+      {
+      return m;
+      }
+   // @}
+};
+
+} // end namespace
+
+#endif
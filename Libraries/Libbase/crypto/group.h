@@ -23,8 +23,10 @@
 #define __group_h
 
 #include "config.h"
+#include "fixedbase.h"
 
 #include <iostream>
+#include <boost/shared_ptr.hpp>
 
 namespace libbase {
 
@@ -35,6 +37,10 @@ namespace libbase {
  * Class that represents the group. Used to save and load previously generated
  * groups.
  *
+ * Powers of the generator g are computed with a fixed-base table, which is
+ * built whenever the group parameters are set, and shared between copies of
+ * the group (so that passing groups by value remains cheap).
+ *
  * The class takes a BigInteger template parameter.
  *
  * \todo Add generation of a new group
@@ -46,6 +52,14 @@ private:
    BigInteger p;
    BigInteger q;
    BigInteger g;
+   boost::shared_ptr<const fixedbase<BigInteger> > g_table;
+
+private:
+   //! Set up fixed-base table for powers of g, with exponents in Z_q
+   void precompute()
+      {
+      g_table.reset(new fixedbase<BigInteger> (g, p, q.size()));
+      }
 
 public:
    /*! \name Constructors / Destructors */
@@ -56,6 +70,7 @@ public:
    explicit group(BigInteger p, BigInteger q, BigInteger g) :
       p(p), q(q), g(g)
       {
+      precompute();
       }
    // @}
 
@@ -64,6 +79,7 @@ public:
       this->p = p;
       this->q = q;
       this->g = g;
+      precompute();
       }
 
    /*! \name Getters */
@@ -92,10 +108,18 @@ public:
       return r;
       }
 
+   //! Compute g^e mod p
+   BigInteger pow_g(const BigInteger& e) const
+      {
+      if (!g_table)
+         return g.pow_mod(e, p);
+      return g_table->pow_mod(e);
+      }
+
    BigInteger sample()
       {
       BigInteger r = get_random_integer(q);
-      return g.pow_mod(r, p);
+      return pow_g(r);
       }
 
    /*! \name Stream I/O */
@@ -112,6 +136,8 @@ public:
       sin >> x.p;
       sin >> x.q;
       sin >> x.g;
+      if (sin)
+         x.precompute();
       return sin;
       }
    // @}
@@ -47,7 +47,7 @@ public:
       {
       BigInteger secretShare = group<BigInteger>::get_random_integer(
             grp.get_q());
-      BigInteger publicShare = grp.get_g().pow_mod(secretShare, grp.get_p());
+      BigInteger publicShare = grp.pow_g(secretShare);
       return keypair<BigInteger> (secretShare, publicShare);
       }
 
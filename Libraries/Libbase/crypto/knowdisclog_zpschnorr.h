@@ -27,6 +27,9 @@
 #include "keygenerator.h"
 #include "sha.h"
 
+#include <vector>
+#include <algorithm>
+
 namespace libbase {
 
 /*!
@@ -35,6 +38,9 @@ namespace libbase {
  *
  * Proof that an entity knows x in v = g^x.
  *
+ * Powers of g use the group's fixed-base table. Many proofs can be checked
+ * together with a batch test, which is split across threads.
+ *
  * The class takes a BigInteger template parameter.
  */
 
@@ -67,9 +73,8 @@ public:
    static knowdisclog_zpschnorr createProof(group<BigInteger> grp,
          BigInteger x, BigInteger v)
       {
-      BigInteger g = grp.get_g();
       BigInteger z = group<BigInteger>::get_random_integer(grp.get_q());
-      BigInteger a = g.pow_mod(z, grp.get_p());
+      BigInteger a = grp.pow_g(z);
 
       std::vector<unsigned char> buf;
       buf += v.bytearray();
@@ -92,11 +97,61 @@ public:
     */
    static bool verifyProof(group<BigInteger> grp, knowdisclog_zpschnorr E)
       {
-      BigInteger u = grp.get_g().pow_mod(E.r, grp.get_p());
+      BigInteger u = grp.pow_g(E.r);
       BigInteger w = (E.v.pow_mod(E.c, grp.get_p()) * E.a) % grp.get_p();
 
       return u == w;
       }
+
+   /* \brief Batch proof verification
+    *
+    * For random 'bits'-bit weights d_i, check that
+    *      g^(sum d_i r_i mod q) = prod a_i^(d_i) v_i^(d_i c_i) (mod p)
+    * where the right-hand side is computed by simultaneous exponentiation.
+    * If all proofs are valid this always holds; otherwise it fails except
+    * with probability about 2^-bits, assuming the proof elements lie in the
+    * subgroup of order q. The proofs are split into one batch per thread.
+    *
+    * Returns true only if all proofs are valid; use verifyProof() to find
+    * the invalid proofs in a failed batch.
+    */
+   static bool verifyProofs(group<BigInteger> grp,
+         const std::vector<knowdisclog_zpschnorr>& proofs, const int bits = 64)
+      {
+      const int n = proofs.size();
+      if (n == 0)
+         return true;
+      // draw weights sequentially, as the generator is shared
+      std::vector<BigInteger> d(n);
+      for (int i = 0; i < n; i++)
+         d[i].random(bits);
+      // check each batch
+      const int batches = std::min(n, getthreadcount());
+      std::vector<int> ok(batches);
+#pragma omp parallel for schedule(dynamic)
+      for (int k = 0; k < batches; k++)
+         {
+         const int i0 = int(libbase::int64s(n) * k / batches);
+         const int i1 = int(libbase::int64s(n) * (k + 1) / batches);
+         BigInteger s(0);
+         std::vector<BigInteger> base, exp;
+         for (int i = i0; i < i1; i++)
+            {
+            const knowdisclog_zpschnorr& E = proofs[i];
+            s = (s + d[i] * E.r) % grp.get_q();
+            base.push_back(E.a);
+            exp.push_back(d[i]);
+            base.push_back(E.v);
+            exp.push_back(d[i] * E.c);
+            }
+         ok[k] = grp.pow_g(s) == BigInteger::multi_pow_mod(base, exp,
+               grp.get_p());
+         }
+      for (int k = 0; k < batches; k++)
+         if (!ok[k])
+            return false;
+      return true;
+      }
 };
 
 } // end namespace
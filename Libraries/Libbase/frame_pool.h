@@ -0,0 +1,186 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __frame_pool_h
+#define __frame_pool_h
+
+#include "config.h"
+#include "walltimer.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace libbase {
+
+/*!
+ * \brief   Ordered Frame Worker Pool.
+ * \author  Johann Briffa
+ *
+ * Processes a sequence of independent frames on a pool of worker threads,
+ * writing the results in input order. Each worker repeatedly takes the next
+ * frame from the input, processes it, and deposits its result in a reorder
+ * buffer; results are written out as soon as all earlier ones are done.
+ *
+ * The reorder buffer holds at most 'depth' frames, from the oldest frame
+ * not yet written to the newest frame taken. When it is full, reading stops
+ * until the oldest frame is done, so that memory use stays bounded however
+ * long a slow frame takes.
+ *
+ * The job object \c T must provide:
+ * - <tt>bool read(F& frame)</tt>, returning false at the end of the input;
+ * this is only called by one thread at a time.
+ * - <tt>void process(int thread, int index, const F& frame,
+ * std::string& result)</tt>, where \c thread is in [0, threads-1] and
+ * \c index is the frame's position in the input; this is called
+ * concurrently, but never concurrently for the same thread.
+ *
+ * Without OpenMP, frames are processed serially by a single worker.
+ *
+ * \tparam F Frame type
+ * \tparam T Job type
+ */
+
+template <class F, class T>
+class frame_pool {
+private:
+   /*! \name User-defined parameters */
+   int threads; //!< Number of worker threads
+   int depth; //!< Size of reorder buffer (in frames)
+   // @}
+   /*! \name Internal object representation */
+   std::vector<std::string> results; //!< Results awaiting output
+   std::vector<int> done; //!< Flags for results ready for output
+   int next_read; //!< Index of next frame to read
+   int next_write; //!< Index of next frame to write
+   bool at_end; //!< Flag indicating the end of input was reached
+   double seconds; //!< Wall-clock time taken by last run
+   // @}
+private:
+   /*! \name Internal functions */
+   int get_written()
+      {
+      int n;
+#pragma omp critical(frame_pool_output)
+      n = next_write;
+      return n;
+      }
+   // @}
+public:
+   /*! \name Constructors / Destructors */
+   /*! \brief Principal constructor
+    * \param threads Number of worker threads
+    * \param depth Size of reorder buffer; by default, twice the number of
+    * threads
+    */
+   explicit frame_pool(const int threads, const int depth = 0) :
+      threads(threads), depth(depth > 0 ? depth : 2 * threads), next_read(0),
+            next_write(0), at_end(false), seconds(0)
+      {
+      assertalways(threads >= 1);
+      assertalways(this->depth >= threads);
+      }
+   // @}
+
+   /*! \name Main process */
+   void run(T& job, std::ostream& sout);
+   // @}
+
+   /*! \name Statistics */
+   //! Number of frames processed in last run
+   int get_frames() const
+      {
+      return next_write;
+      }
+   //! Wall-clock time taken by last run, in seconds
+   double get_seconds() const
+      {
+      return seconds;
+      }
+   //! Throughput of last run, in frames per second
+   double get_throughput() const
+      {
+      return seconds > 0 ? next_write / seconds : 0;
+      }
+   // @}
+};
+
+/*!
+ * \brief Process all frames from the job's input, writing results to 'sout'
+ *
+ * Every worker reads and processes frames until the input is exhausted.
+ * Reading is serialized, as is writing; the reader waits (while holding
+ * the input) when the reorder buffer is full, since no other worker could
+ * take a frame until then anyway.
+ */
+template <class F, class T>
+void frame_pool<F, T>::run(T& job, std::ostream& sout)
+   {
+   walltimer t("frame_pool");
+   results.assign(depth, std::string());
+   done.assign(depth, 0);
+   next_read = 0;
+   next_write = 0;
+   at_end = false;
+#pragma omp parallel num_threads(threads)
+      {
+      F frame;
+      for (;;)
+         {
+         // take the next frame, waiting for space in the reorder buffer
+         int i = -1;
+#pragma omp critical(frame_pool_input)
+            {
+            while (!at_end && next_read - get_written() >= depth)
+               ;
+            if (!at_end && job.read(frame))
+               i = next_read++;
+            else
+               at_end = true;
+            }
+         if (i < 0)
+            break;
+         // process it
+         std::string result;
+         job.process(getthreadid(), i, frame, result);
+         // deposit result, and write out any that are now in order
+#pragma omp critical(frame_pool_output)
+            {
+            results[i % depth].swap(result);
+            done[i % depth] = 1;
+            for (int k = next_write % depth; done[k]; k = next_write % depth)
+               {
+               sout << results[k];
+               results[k].clear();
+               done[k] = 0;
+               next_write++;
+               }
+            }
+         }
+      }
+   sout.flush();
+   t.stop();
+   seconds = t.elapsed();
+   }
+
+} // end namespace
+
+#endif
@@ -0,0 +1,158 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gf2_matrix.h"
+#include <algorithm>
+
+namespace libbase {
+
+// Internal functions
+
+void gf2_matrix::swap_rows(const int i, const int j)
+   {
+   if (i != j)
+      std::swap_ranges(row(i), row(i) + m_words, row(j));
+   }
+
+// Linear algebra
+
+/*!
+ * Columns are processed in groups of k=8 (so that a group never straddles
+ * a word boundary). Within a group, pivots are found by elimination on
+ * just the group's bits for each remaining row; only the rows chosen as
+ * pivots are reduced in full. The pivot rows are then reduced among
+ * themselves, a table of their 2^k linear combinations is built, and every
+ * other row is cleared in the pivot columns by adding the table entry
+ * indexed by its bits in those columns.
+ */
+int gf2_matrix::reduce_to_ref()
+   {
+   const int k = 8;
+   std::vector<int64u> table(m_words << k);
+   std::vector<int> window(m_rows);
+   std::vector<int> piv_col;
+   int r = 0;
+   for (int c = 0; c < m_cols && r < m_rows; c += k)
+      {
+      const int w0 = c >> 6;
+      const int shift = c & 63;
+      const int width = std::min(k, m_cols - c);
+      // extract the group's bits for each remaining row
+      for (int i = r; i < m_rows; i++)
+         window[i] = int((row(i)[w0] >> shift) & 0xff);
+      // find pivots within this group
+      piv_col.clear();
+      for (int b = 0; b < width && r + int(piv_col.size()) < m_rows; b++)
+         {
+         const int p = r + piv_col.size();
+         int i = p;
+         while (i < m_rows && !((window[i] >> b) & 1))
+            i++;
+         if (i == m_rows)
+            continue;
+         swap_rows(i, p);
+         std::swap(window[i], window[p]);
+         // reduce the new pivot row in full by earlier pivots in this group
+         for (int q = 0; q < int(piv_col.size()); q++)
+            if ((*this)(p, piv_col[q]))
+               add_row(p, r + q, w0);
+         // clear this bit from the remaining rows' group bits
+         for (i = p + 1; i < m_rows; i++)
+            if ((window[i] >> b) & 1)
+               window[i] ^= window[p];
+         piv_col.push_back(c + b);
+         }
+      const int found = piv_col.size();
+      if (found == 0)
+         continue;
+      // reduce pivot rows among themselves
+      for (int q = found - 1; q > 0; q--)
+         for (int p = 0; p < q; p++)
+            if ((*this)(r + p, piv_col[q]))
+               add_row(r + p, r + q, w0);
+      // tabulate all combinations of pivot rows
+      std::fill(&table[w0], &table[m_words], int64u(0));
+      for (int idx = 1; idx < (1 << found); idx++)
+         {
+         int low = 0;
+         while (!((idx >> low) & 1))
+            low++;
+         const int64u* prev = &table[(idx & (idx - 1)) * m_words];
+         const int64u* src = row(r + low);
+         int64u* dst = &table[idx * m_words];
+         for (int w = w0; w < m_words; w++)
+            dst[w] = prev[w] ^ src[w];
+         }
+      // clear the pivot columns in all other rows
+      for (int i = 0; i < m_rows; i++)
+         {
+         if (i == r)
+            {
+            i += found - 1;
+            continue;
+            }
+         int idx = 0;
+         for (int q = 0; q < found; q++)
+            if ((*this)(i, piv_col[q]))
+               idx |= 1 << q;
+         if (idx == 0)
+            continue;
+         const int64u* src = &table[idx * m_words];
+         int64u* dst = row(i);
+         for (int w = w0; w < m_words; w++)
+            dst[w] ^= src[w];
+         }
+      r += found;
+      }
+   return r;
+   }
+
+gf2_matrix gf2_matrix::null_space() const
+   {
+   gf2_matrix ref = *this;
+   const int rank = ref.reduce_to_ref();
+   // determine pivot columns
+   std::vector<int> pivot(rank);
+   std::vector<bool> is_pivot(m_cols, false);
+   for (int i = 0, j = 0; i < rank; i++)
+      {
+      while (!ref(i, j))
+         j++;
+      pivot[i] = j;
+      is_pivot[j] = true;
+      }
+   // each free column gives a basis vector, with the pivot symbols set to
+   // satisfy each row of the echelon form
+   gf2_matrix result(m_cols - rank, m_cols);
+   for (int j = 0, t = 0; j < m_cols; j++)
+      {
+      if (is_pivot[j])
+         continue;
+      result.set(t, j, true);
+      for (int i = 0; i < rank; i++)
+         if (ref(i, j))
+            result.set(t, pivot[i], true);
+      t++;
+      }
+   return result;
+   }
+
+} // end namespace
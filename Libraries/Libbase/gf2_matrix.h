@@ -0,0 +1,200 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __gf2_matrix_h
+#define __gf2_matrix_h
+
+#include "config.h"
+#include "vector.h"
+#include "matrix.h"
+
+#include <vector>
+
+namespace libbase {
+
+/*!
+ * \brief   Bit-packed Binary Matrix.
+ * \author  Johann Briffa
+ *
+ * Matrix over GF(2), with each row packed into 64-bit words, intended for
+ * the linear algebra needed when setting up binary codes: reduction to
+ * row echelon form, rank, and null space.
+ *
+ * Reduction uses the Method of Four Russians (M4RI): pivots are found a few
+ * columns at a time, a table of all linear combinations of that group of
+ * pivot rows is built, and every other row is then cleared in those
+ * columns with a single table lookup and row addition.
+ *
+ * Conversion to and from libbase::matrix treats any non-zero entry as 1, so
+ * this works with matrix<gf<1,0x3> >, matrix<bool> and matrix<int>.
+ */
+
+class gf2_matrix {
+private:
+   /*! \name Internal representation */
+   int m_rows; //!< Number of rows
+   int m_cols; //!< Number of columns
+   int m_words; //!< Number of words per row
+   std::vector<int64u> m_data; //!< Packed rows, consecutively
+   // @}
+private:
+   /*! \name Internal functions */
+   //! Pointer to start of row 'i'
+   int64u* row(const int i)
+      {
+      return &m_data[i * m_words];
+      }
+   //! Pointer to start of row 'i' (read-only)
+   const int64u* row(const int i) const
+      {
+      return &m_data[i * m_words];
+      }
+   //! Add row 'src' to row 'dst', starting from word 'w0'
+   void add_row(const int dst, const int src, const int w0)
+      {
+      int64u* d = row(dst);
+      const int64u* s = row(src);
+      for (int w = w0; w < m_words; w++)
+         d[w] ^= s[w];
+      }
+   //! Swap rows 'i' and 'j'
+   void swap_rows(const int i, const int j);
+   // @}
+public:
+   /*! \name Constructors / Destructors */
+   //! Default constructor, creating an all-zero matrix
+   explicit gf2_matrix(const int rows = 0, const int cols = 0)
+      {
+      init(rows, cols);
+      }
+   //! Conversion from a matrix of field elements (non-zero entries map to 1)
+   template <class T>
+   explicit gf2_matrix(const matrix<T>& A)
+      {
+      init(A.size().rows(), A.size().cols());
+      for (int i = 0; i < m_rows; i++)
+         for (int j = 0; j < m_cols; j++)
+            if (A(i, j) != T(0))
+               set(i, j, true);
+      }
+   // @}
+
+   /*! \name Resizing operations */
+   //! Set size, clearing all elements
+   void init(const int rows, const int cols)
+      {
+      assert(rows >= 0 && cols >= 0);
+      m_rows = rows;
+      m_cols = cols;
+      m_words = (cols + 63) / 64;
+      m_data.assign(rows * m_words, 0);
+      }
+   // @}
+
+   /*! \name Element access */
+   //! Element at row 'i', column 'j'
+   bool operator()(const int i, const int j) const
+      {
+      assert(i >= 0 && i < m_rows && j >= 0 && j < m_cols);
+      return (row(i)[j >> 6] >> (j & 63)) & 1;
+      }
+   //! Set element at row 'i', column 'j'
+   void set(const int i, const int j, const bool x)
+      {
+      assert(i >= 0 && i < m_rows && j >= 0 && j < m_cols);
+      const int64u mask = int64u(1) << (j & 63);
+      if (x)
+         row(i)[j >> 6] |= mask;
+      else
+         row(i)[j >> 6] &= ~mask;
+      }
+   //! Copy to a matrix of field elements
+   template <class T>
+   void copyto(matrix<T>& A) const
+      {
+      A.init(m_rows, m_cols);
+      for (int i = 0; i < m_rows; i++)
+         for (int j = 0; j < m_cols; j++)
+            A(i, j) = (*this)(i, j) ? T(1) : T(0);
+      }
+   // @}
+
+   /*! \name Linear algebra */
+   /*! \brief Reduce to row echelon form, in place
+    * The result is the same as matrix<T>::reduce_to_ref(): pivots are 1,
+    * with zeros above and below, and any zero rows are at the bottom.
+    * \return The rank of the matrix
+    */
+   int reduce_to_ref();
+   //! Rank of this matrix
+   int rank() const
+      {
+      gf2_matrix ref = *this;
+      return ref.reduce_to_ref();
+      }
+   /*! \brief Basis of the null space
+    * Returns a matrix whose rows form a basis for the set of vectors x such
+    * that A.x = 0; for a generator matrix, this is a parity-check matrix.
+    */
+   gf2_matrix null_space() const;
+   /*! \brief Matrix-vector product, y = A.x
+    * Non-zero entries of 'x' count as 1; entries of 'y' are 0 or 1.
+    */
+   template <class T>
+   void multiply(const vector<T>& x, vector<T>& y) const
+      {
+      assert(x.size() == m_cols);
+      std::vector<int64u> xp(m_words, 0);
+      for (int j = 0; j < m_cols; j++)
+         if (x(j) != T(0))
+            xp[j >> 6] |= int64u(1) << (j & 63);
+      y.init(m_rows);
+      for (int i = 0; i < m_rows; i++)
+         {
+         int64u s = 0;
+         const int64u* r = row(i);
+         for (int w = 0; w < m_words; w++)
+            s ^= r[w] & xp[w];
+         // parity of the accumulated word
+         for (int b = 32; b > 0; b >>= 1)
+            s ^= s >> b;
+         y(i) = (s & 1) ? T(1) : T(0);
+         }
+      }
+   // @}
+
+   /*! \name Information functions */
+   //! Number of rows
+   int rows() const
+      {
+      return m_rows;
+      }
+   //! Number of columns
+   int cols() const
+      {
+      return m_cols;
+      }
+   // @}
+};
+
+} // end namespace
+
+#endif
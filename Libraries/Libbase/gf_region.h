@@ -0,0 +1,242 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __gf_region_h
+#define __gf_region_h
+
+#include "config.h"
+#include "gf.h"
+#include "vector.h"
+#include "matrix.h"
+
+#ifdef __SSSE3__
+#  include <tmmintrin.h>
+#endif
+
+namespace libbase {
+
+template <class GF_q>
+class gf_region;
+
+/*!
+ * \brief   Region arithmetic over GF(2^m).
+ * \author  Johann Briffa
+ *
+ * Operations on whole arrays of field elements, as needed by linear block
+ * encoders and syndrome computation:
+ * - multiply-accumulate of a region by a constant (y += c.x)
+ * - dot product of two regions
+ * - matrix-vector and vector-matrix products
+ *
+ * Multiplication by a constant uses split tables: the constant's product
+ * with every 4-bit slice of the multiplicand is tabulated, so that
+ * c.x = T_0[x & 0xf] + T_1[(x >> 4) & 0xf] + ... For fields of up to 256
+ * elements, when compiled with SSSE3 support, the table lookups are done
+ * sixteen bytes at a time with byte shuffles. Products of two variables
+ * (as in dot products) use log/antilog tables.
+ *
+ * \note Region operations work directly on the integer representation held
+ * by each gf object, which must therefore be the object's only member.
+ */
+
+template <int m, int poly>
+class gf_region<gf<m, poly> > {
+public:
+   /*! \name Type definitions */
+   typedef gf<m, poly> GF_q;
+   // @}
+
+private:
+   /*! \name Internal representation */
+   //! Number of 4-bit slices in a field element
+   enum {
+      slices = (m + 3) / 4
+   };
+   /*! \brief Log and antilog tables (antilog is doubled to avoid reduction)
+    * The base is the smallest primitive element, which is not necessarily
+    * 'x' as the field polynomial need not be primitive.
+    */
+   struct log_tables {
+      int log[1 << m];
+      int exp[2 << m];
+      log_tables()
+         {
+         const int q1 = (1 << m) - 1;
+         // find a primitive element
+         GF_q g = 1;
+         for (int c = (q1 == 1) ? 1 : 2; c <= q1; c++)
+            {
+            g = GF_q(c);
+            int order = 1;
+            for (GF_q x = g; x != GF_q(1); x *= g)
+               order++;
+            if (order == q1)
+               break;
+            }
+         // tabulate its powers
+         log[0] = 0; // by convention; not used
+         GF_q x = 1;
+         for (int i = 0; i < 2 * q1; i++)
+            {
+            exp[i] = x;
+            if (i < q1)
+               log[int(x)] = i;
+            x *= g;
+            }
+         }
+   };
+   // @}
+
+   /*! \name Internal functions */
+   //! Shared log/antilog tables, created on first use
+   static const log_tables& get_log_tables()
+      {
+      static const log_tables t;
+      return t;
+      }
+   //! Create split multiplication tables for constant 'c'
+   static void make_split(const GF_q c, int t[][16])
+      {
+      for (int k = 0; k < slices; k++)
+         for (int x = 0; x < 16; x++)
+            {
+            const int v = x << (4 * k);
+            t[k][x] = (v < (1 << m)) ? int(c * GF_q(v)) : 0;
+            }
+      }
+   //! Integer representation of a region of field elements (read-only)
+   static const int* raw(const GF_q* x)
+      {
+      assert(sizeof(GF_q) == sizeof(int));
+      return reinterpret_cast<const int*> (x);
+      }
+   //! Integer representation of a region of field elements
+   static int* raw(GF_q* x)
+      {
+      assert(sizeof(GF_q) == sizeof(int));
+      return reinterpret_cast<int*> (x);
+      }
+   // @}
+
+public:
+   /*! \name Region operations */
+   /*! \brief Multiply-accumulate, y(i) += c.x(i) for 0<=i<n
+    */
+   static void mul_add(const GF_q c, const GF_q* x, GF_q* y, const int n)
+      {
+      if (c == GF_q(0) || n == 0)
+         return;
+      const int* xi = raw(x);
+      int* yi = raw(y);
+      int t[slices][16];
+      make_split(c, t);
+      int i = 0;
+#ifdef __SSSE3__
+      if (m <= 8)
+         {
+         // each int holds one element in its low byte, with zero bytes above,
+         // which map to zero through both tables
+         int8u lo[16], hi[16];
+         for (int x = 0; x < 16; x++)
+            {
+            lo[x] = int8u(t[0][x]);
+            hi[x] = int8u(slices > 1 ? t[slices - 1][x] : 0);
+            }
+         const __m128i tlo = _mm_loadu_si128((const __m128i*) lo);
+         const __m128i thi = _mm_loadu_si128((const __m128i*) hi);
+         const __m128i mask = _mm_set1_epi8(0x0f);
+         for (; i + 4 <= n; i += 4)
+            {
+            const __m128i vx = _mm_loadu_si128((const __m128i*) (xi + i));
+            const __m128i vy = _mm_loadu_si128((const __m128i*) (yi + i));
+            const __m128i plo = _mm_shuffle_epi8(tlo, _mm_and_si128(vx, mask));
+            const __m128i phi = _mm_shuffle_epi8(thi, _mm_and_si128(
+                  _mm_srli_epi16(vx, 4), mask));
+            _mm_storeu_si128((__m128i*) (yi + i), _mm_xor_si128(vy,
+                  _mm_xor_si128(plo, phi)));
+            }
+         }
+#endif
+      for (; i < n; i++)
+         {
+         int v = xi[i];
+         int p = 0;
+         for (int k = 0; k < slices; k++, v >>= 4)
+            p ^= t[k][v & 0xf];
+         yi[i] ^= p;
+         }
+      }
+   /*! \brief Multiply-accumulate, y += c.x for whole vectors
+    */
+   static void mul_add(const GF_q c, const vector<GF_q>& x, vector<GF_q>& y)
+      {
+      assert(x.size() == y.size());
+      if (x.size() > 0)
+         mul_add(c, &x(0), &y(0), x.size());
+      }
+   /*! \brief Dot product, sum of x(i).y(i) for 0<=i<n
+    */
+   static GF_q dot(const GF_q* x, const GF_q* y, const int n)
+      {
+      const log_tables& t = get_log_tables();
+      const int* xi = raw(x);
+      const int* yi = raw(y);
+      int s = 0;
+      for (int i = 0; i < n; i++)
+         if (xi[i] != 0 && yi[i] != 0)
+            s ^= t.exp[t.log[xi[i]] + t.log[yi[i]]];
+      return GF_q(s);
+      }
+   /*! \brief Matrix-vector product, y = A.x (as for syndrome computation)
+    */
+   static void multiply(const matrix<GF_q>& A, const vector<GF_q>& x,
+         vector<GF_q>& y)
+      {
+      const int rows = A.size().rows();
+      const int cols = A.size().cols();
+      assert(x.size() == cols);
+      y.init(rows);
+      for (int i = 0; i < rows; i++)
+         y(i) = (cols > 0) ? dot(&A(i, 0), &x(0), cols) : GF_q(0);
+      }
+   /*! \brief Vector-matrix product, y = x.A (as for encoding)
+    * This accumulates the rows of A, each scaled by the corresponding
+    * element of x.
+    */
+   static void multiply(const vector<GF_q>& x, const matrix<GF_q>& A,
+         vector<GF_q>& y)
+      {
+      const int rows = A.size().rows();
+      const int cols = A.size().cols();
+      assert(x.size() == rows);
+      y.init(cols);
+      y = GF_q(0);
+      if (cols == 0)
+         return;
+      for (int i = 0; i < rows; i++)
+         mul_add(x(i), &A(i, 0), &y(0), cols);
+      }
+   // @}
+};
+
+} // end namespace
+
+#endif
@@ -24,7 +24,9 @@
 
 #include "config.h"
 #include "vector.h"
-#include "matrix.h"
+
+#include <vector>
+#include <algorithm>
 
 namespace libbase {
 
@@ -34,6 +36,14 @@ namespace libbase {
  *
  * A method that computes the Levenshtein distance between two sequences.
  * Templatized for any type for which a definition of equality exists.
+ *
+ * This uses the bit-vector algorithm of Myers (J. ACM, 1999), in the
+ * block-based form given by Hyyrö (2003): the differences between adjacent
+ * entries of each column of the dynamic programming table are held as bit
+ * vectors, one bit per symbol of 's', so that each symbol of 't' is
+ * processed with a few word operations per 64 symbols of 's'. Time is
+ * O(ceil(m/64).n) and memory is O(ceil(m/64).a), where 'a' is the number
+ * of distinct symbols in 's'; this suits binary and small alphabets.
  */
 
 template <class T>
@@ -41,30 +51,126 @@ int levenshtein(const vector<T>& s, const vector<T>& t)
    {
    const int m = s.size();
    const int n = t.size();
-
-   // d is a table with m+1 rows and n+1 columns
-   matrix<int> d(m + 1, n + 1);
-
-   // initialize values on edges
-   for (int i = 0; i <= m; i++)
-      d(i, 0) = i; // deletions
-   for (int j = 0; j <= n; j++)
-      d(0, j) = j; // insertion
-
-   // fill in the rest of the table
+   if (m == 0)
+      return n;
+   // number of words per column, and mask for the bit of the last symbol
+   const int words = (m + 63) / 64;
+   const int64u last = int64u(1) << ((m - 1) & 63);
+   const int64u high = int64u(1) << 63;
+   // match vectors for each distinct symbol in s
+   std::vector<T> alphabet;
+   std::vector<int64u> peq;
+   for (int i = 0; i < m; i++)
+      {
+      const int a = std::find(alphabet.begin(), alphabet.end(), s(i))
+            - alphabet.begin();
+      if (a == int(alphabet.size()))
+         {
+         alphabet.push_back(s(i));
+         peq.resize(peq.size() + words, 0);
+         }
+      peq[a * words + (i >> 6)] |= int64u(1) << (i & 63);
+      }
+   const std::vector<int64u> nomatch(words, 0);
+   // vertical positive/negative differences; initially D(i,0) = i
+   std::vector<int64u> pv(words, ~int64u(0));
+   std::vector<int64u> mv(words, 0);
+   int score = m;
    for (int j = 0; j < n; j++)
-      for (int i = 0; i < m; i++)
+      {
+      const int a = std::find(alphabet.begin(), alphabet.end(), t(j))
+            - alphabet.begin();
+      const int64u* eqv = (a < int(alphabet.size())) ? &peq[a * words]
+            : &nomatch[0];
+      // top row is D(0,j) = j, so the horizontal difference entering is +1
+      int hin = 1;
+      for (int b = 0; b < words; b++)
          {
-         if (s(i) == t(j))
-            d(i + 1, j + 1) = d(i, j);
-         else
-            d(i + 1, j + 1) = std::min(std::min(//
-                  d(i, j + 1) + 1, // deletion
-                  d(i + 1, j) + 1), // insertion
-                  d(i, j) + 1); // substitution
+         int64u eq = eqv[b];
+         const int64u xv = eq | mv[b];
+         if (hin < 0)
+            eq |= 1;
+         const int64u xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+         int64u ph = mv[b] | ~(xh | pv[b]);
+         int64u mh = pv[b] & xh;
+         // horizontal difference leaving this block (at its last symbol)
+         const int64u out = (b == words - 1) ? last : high;
+         const int hout = (ph & out) ? 1 : ((mh & out) ? -1 : 0);
+         ph <<= 1;
+         mh <<= 1;
+         if (hin < 0)
+            mh |= 1;
+         else if (hin > 0)
+            ph |= 1;
+         pv[b] = mh | ~(xv | ph);
+         mv[b] = ph & xv;
+         hin = hout;
          }
+      score += hin;
+      }
+   return score;
+   }
+
+/*!
+ * \brief   Compute Levenshtein Distance within a band
+ * \author  Johann Briffa
+ *
+ * Computes the Levenshtein distance between two sequences, considering
+ * only alignments where the drift |i-j| between positions in 's' and 't'
+ * never exceeds 'band'. The result is exact if some optimal alignment stays
+ * within the band, and an upper bound otherwise. In particular, for
+ * sequences of equal length with Hamming distance h, a band of h/2 is
+ * always sufficient.
+ *
+ * Time is O(band.n) and memory O(band); when the band is wide enough for
+ * this to be slower than the bit-vector algorithm, the latter is used.
+ */
 
-   return d(m, n);
+template <class T>
+int levenshtein(const vector<T>& s, const vector<T>& t, const int band)
+   {
+   const int m = s.size();
+   const int n = t.size();
+   assert(band >= 0);
+   // use the unbanded algorithm if it would be faster
+   if (2 * band + 1 >= 4 * ((m + 63) / 64))
+      return levenshtein(s, t);
+   // the end point must be reachable within the band
+   if (std::abs(m - n) > band)
+      return levenshtein(s, t);
+   // column j holds D(i,j) for j-band <= i <= j+band, at index i-j+band;
+   // entries outside the table or the band are 'infinite'
+   const int width = 2 * band + 1;
+   const int inf = m + n + 1;
+   std::vector<int> prev(width, inf), cur(width, inf);
+   for (int i = 0; i <= std::min(m, band); i++)
+      prev[i + band] = i;
+   for (int j = 1; j <= n; j++)
+      {
+      const int i0 = std::max(0, j - band);
+      const int i1 = std::min(m, j + band);
+      std::fill(cur.begin(), cur.end(), inf);
+      for (int i = i0; i <= i1; i++)
+         {
+         const int k = i - j + band;
+         if (i == 0)
+            {
+            cur[k] = j; // insertions
+            continue;
+            }
+         // substitution or match, from D(i-1,j-1) at the same index
+         int d = prev[k] + ((s(i - 1) == t(j - 1)) ? 0 : 1);
+         // deletion, from D(i-1,j)
+         if (k > 0)
+            d = std::min(d, cur[k - 1] + 1);
+         // insertion, from D(i,j-1)
+         if (k < width - 1)
+            d = std::min(d, prev[k + 1] + 1);
+         cur[k] = d;
+         }
+      std::swap(prev, cur);
+      }
+   return prev[m - n + band];
    }
 
 } // end namespace
@@ -23,9 +23,29 @@
 #include <iostream>
 #include <algorithm>
 #include "logrealfast.h"
+#include "gf_region.h"
+#include "gf2_matrix.h"
+#include "gf.h"
 
 namespace libbase {
 
+// Reduction to REF: generic version
+template <class GF_q>
+matrix<GF_q> reduce_matrix_to_ref(const matrix<GF_q>& mat)
+   {
+   return mat.reduce_to_ref();
+   }
+
+// Reduction to REF: binary version, using bit-packed rows
+inline matrix<gf<1, 0x3> > reduce_matrix_to_ref(const matrix<gf<1, 0x3> >& mat)
+   {
+   gf2_matrix packed(mat);
+   packed.reduce_to_ref();
+   matrix<gf<1, 0x3> > ref;
+   packed.copyto(ref);
+   return ref;
+   }
+
 // Determine debug level:
 // 1 - Normal debug output only
 // 2 - Show intermediate decoding output
@@ -181,6 +201,12 @@ void linear_code_utils<GF_q, real>::compute_dual_code(
 
    }
 
+template <class GF_q, class real>
+matrix<GF_q> linear_code_utils<GF_q, real>::compute_ref(const matrix<GF_q>& mat)
+   {
+   return reduce_matrix_to_ref(mat);
+   }
+
 template <class GF_q, class real>
 void linear_code_utils<GF_q, real>::compute_row_dim(const matrix<GF_q>& orgMat,
       matrix<GF_q> & maxRowSpaceMat)
@@ -189,7 +215,7 @@ void linear_code_utils<GF_q, real>::compute_row_dim(const matrix<GF_q>& orgMat,
    int dim_k = orgMat.size().rows();
 
    //copy original matrix and reduce it to REF, ie G'=(I_k|P)
-   matrix<GF_q> refOrgMat(orgMat.reduce_to_ref());
+   matrix<GF_q> refOrgMat(compute_ref(orgMat));
 
 #if DEBUG>=2
    std::cout << "The REF is given by:" << std::endl;
@@ -266,16 +292,15 @@ void linear_code_utils<GF_q, real>::encode_cw(const matrix<GF_q> & mat_G,
 
    assertalways(dim_k == source.size().length());
 
+   // accumulate the rows of G, scaled by the corresponding source symbol
+   array1gfq_t cw;
+   array1gfq_t src(dim_k);
+   for (int j = 0; j < dim_k; j++)
+      src(j) = GF_q(source(j));
+   gf_region<GF_q>::multiply(src, mat_G, cw);
    encoded.init(length_n);
    for (int i = 0; i < length_n; i++)
-      {
-      GF_q val = GF_q(0);
-      for (int j = 0; j < dim_k; j++)
-         {
-         val += GF_q(source(j)) * mat_G(j, i);
-         }
-      encoded(i) = val;
-      }
+      encoded(i) = cw(i);
 #if DEBUG>=2
    libbase::trace << std::endl << "finished encoding";
 #endif
@@ -293,23 +318,14 @@ bool linear_code_utils<GF_q, real>::compute_syndrome(
    //check that we have compatible lengths
    assertalways(received_word_hd.size().length() == length_n);
 
-   syndrome_vec.init(dim_m);
-   GF_q tmp_val = GF_q(0);
-
+   gf_region<GF_q>::multiply(parMat, received_word_hd, syndrome_vec);
    for (int rows = 0; rows < dim_m; rows++)
       {
-      tmp_val = GF_q(0);
-      for (int cols = 0; cols < length_n; cols++)
-         {
-         tmp_val += parMat(rows, cols) * received_word_hd(cols);
-         }
-      if (tmp_val != GF_q(0))
+      if (syndrome_vec(rows) != GF_q(0))
          {
          //the syndrome is non-zero
          dec_success = false;
          }
-      syndrome_vec(rows) = tmp_val;
-
       }
    return dec_success;
 
@@ -52,6 +52,13 @@ public:
    static void compute_dual_code(const libbase::matrix<GF_q> & orgMat,
          libbase::matrix<GF_q> & dualCodeMatrix, array1i_t & systematic_perm);
 
+   /*
+    * !This reduces the given matrix to REF, as matrix::reduce_to_ref().
+    * For binary matrices this uses bit-packed elimination, which is much
+    * faster for the large matrices of LDPC codes.
+    */
+   static libbase::matrix<GF_q> compute_ref(const libbase::matrix<GF_q> & mat);
+
    /*
     * !This computes the row space of a parity check matrix,
     * ie given an mxn matrix H, this method determines the linear
@@ -20,6 +20,7 @@
  */
 
 #include "masterslave.h"
+#include "packedvector.h"
 
 #include "timer.h"
 #include "pacifier.h"
@@ -269,14 +270,12 @@ void masterslave::send(const void *buf, const size_t len)
    }
 
 /*! \brief Send a vector<double> to the master
- * \note Vector size is sent first; this makes foreknowledge of size and
- * pre-initialization unnecessary.
+ * \note The vector is sent in packed form, which includes its size; this
+ * makes foreknowledge of size and pre-initialization unnecessary.
  */
 void masterslave::send(const vector<double>& x)
    {
-   const int count = x.size();
-   send(count);
-   send(&x(0), sizeof(double) * count);
+   send(pack(x));
    }
 
 void masterslave::send(const std::string& x)
@@ -515,17 +514,14 @@ void masterslave::receive(boost::shared_ptr<socket> s, void *buf, const size_t l
    }
 
 /*! \brief Receive a vector<double> from given slave
- * \note Vector size is obtained first; this makes foreknowledge of size and
- * pre-initialization unnecessary.
+ * \note The vector is received in packed form, which includes its size; this
+ * makes foreknowledge of size and pre-initialization unnecessary.
  */
 void masterslave::receive(boost::shared_ptr<socket> s, vector<double>& x)
    {
-   // get vector size first
-   int count;
-   receive(s, count);
-   // initialize vector and get vector elements
-   x.init(count);
-   receive(s, &x(0), sizeof(double) * count);
+   std::string packed;
+   receive(s, packed);
+   unpack(packed, x);
    }
 
 void masterslave::receive(boost::shared_ptr<socket> s, std::string& x)
@@ -22,6 +22,7 @@
 #ifdef USE_GMP
 
 #include "gmp_bigint.h"
+#include <algorithm>
 
 namespace libbase {
 
@@ -30,6 +31,76 @@ namespace libbase {
 gmp_randstate_t gmp_bigint::state;
 bool gmp_bigint::state_initialized = false;
 
+// Exponentiation
+
+/*!
+ * Each base is given a table of its powers 1..2^w-1; the exponents are then
+ * scanned together from the most significant end, w bits at a time, with w
+ * squarings of the accumulator per window (shared by all terms) and one
+ * multiplication per non-zero window of each exponent. The window size is
+ * chosen to minimise the combined table and multiplication cost.
+ */
+gmp_bigint gmp_bigint::multi_pow_mod(const std::vector<gmp_bigint>& base,
+      const std::vector<gmp_bigint>& exp, const gmp_bigint& mod)
+   {
+   assertalways(base.size() == exp.size());
+   const int n = base.size();
+   // determine longest exponent
+   size_t bits = 0;
+   for (int i = 0; i < n; i++)
+      {
+      assertalways(mpz_sgn(exp[i].value) >= 0);
+      if (mpz_sgn(exp[i].value) > 0)
+         bits = std::max(bits, exp[i].size());
+      }
+   gmp_bigint r(1);
+   mpz_mod(r.value, r.value, mod.value);
+   if (bits == 0)
+      return r;
+   // choose window size
+   int w = 1;
+   for (int k = 2; k <= 6; k++)
+      if ((n << k) + n * ((bits + k - 1) / k) < (n << w) + n * ((bits + w
+            - 1) / w))
+         w = k;
+   const int entries = 1 << w;
+   // tabulate powers of each base
+   std::vector<gmp_bigint> table(n * entries);
+   for (int i = 0; i < n; i++)
+      {
+      gmp_bigint* t = &table[i * entries];
+      mpz_mod(t[1].value, base[i].value, mod.value);
+      for (int d = 2; d < entries; d++)
+         {
+         mpz_mul(t[d].value, t[d - 1].value, t[1].value);
+         mpz_mod(t[d].value, t[d].value, mod.value);
+         }
+      }
+   // scan exponents together, one window at a time
+   bool started = false;
+   for (int j = (bits + w - 1) / w - 1; j >= 0; j--)
+      {
+      if (started)
+         for (int k = 0; k < w; k++)
+            {
+            mpz_mul(r.value, r.value, r.value);
+            mpz_mod(r.value, r.value, mod.value);
+            }
+      for (int i = 0; i < n; i++)
+         {
+         int d = 0;
+         for (int k = w - 1; k >= 0; k--)
+            d = (d << 1) | mpz_tstbit(exp[i].value, j * w + k);
+         if (d == 0)
+            continue;
+         mpz_mul(r.value, r.value, table[i * entries + d].value);
+         mpz_mod(r.value, r.value, mod.value);
+         started = true;
+         }
+      }
+   return r;
+   }
+
 } // end namespace
 
 #endif
@@ -42,7 +42,9 @@ namespace libbase {
  * - random initialization with a given bit length
  * - the number of digits needed to represent the value, given base
  * - pow_mod() method to compute exponentiation modulo m
+ * - multi_pow_mod() method to compute a product of powers modulo m
  * - inv_mod() method to compute inverse modulo m
+ * - access to individual bits
  * - comparison operators
  * - arithmetic operators: + * %
  * - conversion to/from byte arrays
@@ -108,6 +110,13 @@ public:
       mpz_powm(r.value, value, exp.value, mod.value);
       return r;
       }
+   /*! \brief Compute a product of powers modulo m
+    * Returns the product of base[i]^exp[i] mod m, computed simultaneously
+    * (Straus' method) so that the squarings are shared between all terms.
+    * Exponents must be non-negative.
+    */
+   static gmp_bigint multi_pow_mod(const std::vector<gmp_bigint>& base,
+         const std::vector<gmp_bigint>& exp, const gmp_bigint& mod);
    //! Compute inverse modulo m
    gmp_bigint inv_mod(const gmp_bigint& mod) const
       {
@@ -116,6 +125,14 @@ public:
       return r;
       }
 
+   /*! \name Bit access */
+   //! Value of bit 'i' (in two's complement, for negative values)
+   bool test_bit(unsigned long i) const
+      {
+      return mpz_tstbit(value, i) != 0;
+      }
+   // @}
+
    /*! \name Comparison operations */
    bool operator==(const gmp_bigint& x) const
       {
@@ -0,0 +1,148 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "packedvector.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace libbase {
+
+namespace {
+
+//! Largest magnitude for which every integer is representable as a double
+const double maxexact = 9007199254740992.0;
+
+enum {
+   token_zeros = 0, token_integer, token_double
+};
+
+void put_varint(std::string& s, int64u v)
+   {
+   while (v >= 0x80)
+      {
+      s += char(0x80 | (v & 0x7f));
+      v >>= 7;
+      }
+   s += char(v);
+   }
+
+int64u get_varint(const std::string& s, size_t& pos)
+   {
+   int64u v = 0;
+   for (int shift = 0;; shift += 7)
+      {
+      assertalways(pos < s.size() && shift < 64);
+      const int64u b = int8u(s[pos++]);
+      v |= (b & 0x7f) << shift;
+      if (!(b & 0x80))
+         return v;
+      }
+   }
+
+} // end unnamed namespace
+
+std::string pack(const vector<double>& x)
+   {
+   std::string s;
+   s.reserve(x.size() + 8);
+   put_varint(s, x.size());
+   int64s prev = 0;
+   for (int i = 0; i < x.size();)
+      {
+      const double v = x(i);
+      if (v == 0)
+         {
+         int n = 1;
+         while (i + n < x.size() && x(i + n) == 0)
+            n++;
+         put_varint(s, (int64u(n - 1) << 2) | token_zeros);
+         i += n;
+         }
+      else if (std::fabs(v) <= maxexact && v == std::floor(v))
+         {
+         const int64s k = int64s(v);
+         const int64s d = k - prev;
+         const int64u z = (int64u(d) << 1) ^ int64u(d >> 63);
+         put_varint(s, (z << 2) | token_integer);
+         prev = k;
+         i++;
+         }
+      else
+         {
+         int64u bits;
+         std::memcpy(&bits, &v, sizeof(bits));
+         put_varint(s, token_double);
+         for (int b = 0; b < 8; b++, bits >>= 8)
+            s += char(bits & 0xff);
+         i++;
+         }
+      }
+   return s;
+   }
+
+void unpack(const std::string& s, vector<double>& x)
+   {
+   size_t pos = 0;
+   const int64u size = get_varint(s, pos);
+   assertalways(size <= int64u(std::numeric_limits<int>::max()));
+   x.init(int(size));
+   int64s prev = 0;
+   for (int i = 0; i < x.size();)
+      {
+      const int64u h = get_varint(s, pos);
+      switch (h & 3)
+         {
+         case token_zeros:
+            {
+            const int64u n = (h >> 2) + 1;
+            assertalways(n <= int64u(x.size() - i));
+            for (int j = 0; j < int(n); j++)
+               x(i++) = 0;
+            }
+            break;
+         case token_integer:
+            {
+            const int64u z = h >> 2;
+            prev += int64s(z >> 1) ^ -int64s(z & 1);
+            x(i++) = double(prev);
+            }
+            break;
+         case token_double:
+            {
+            assertalways(pos + 8 <= s.size());
+            int64u bits = 0;
+            for (int b = 7; b >= 0; b--)
+               bits = (bits << 8) | int8u(s[pos + b]);
+            pos += 8;
+            double v;
+            std::memcpy(&v, &bits, sizeof(v));
+            x(i++) = v;
+            }
+            break;
+         default:
+            failwith("Invalid token in packed vector");
+         }
+      }
+   assertalways(pos == s.size());
+   }
+
+} // end namespace
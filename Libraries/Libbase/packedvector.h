@@ -0,0 +1,57 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __packedvector_h
+#define __packedvector_h
+
+#include "config.h"
+#include "vector.h"
+#include <string>
+
+namespace libbase {
+
+/*!
+ * \brief   Compact Encoding of Vectors of Doubles.
+ * \author  Johann Briffa
+ *
+ * Byte encoding for vectors whose elements are mostly small integers and
+ * zeros, such as the accumulated state of result collectors (error counts
+ * per position or histogram bins). The vector size is followed by a
+ * sequence of tokens, each starting with a variable-length integer (seven
+ * bits per byte, least-significant group first, with the top bit set on
+ * all but the last byte); the two low-order bits give the token type:
+ * - 0: a run of zeros, of length given by the remaining bits, plus one
+ * - 1: an integer value, given by the difference from the previous integer
+ * value in zig-zag form (so that small differences of either sign are short)
+ * - 2: any other value, given as the following eight bytes (IEEE 754,
+ * least-significant byte first)
+ *
+ * Encoding is exact, except that negative zero is stored as zero.
+ */
+
+//! Encode a vector into a compact byte string
+std::string pack(const vector<double>& x);
+//! Decode a vector from a compact byte string
+void unpack(const std::string& s, vector<double>& x);
+
+} // end namespace
+
+#endif
@@ -0,0 +1,232 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tablecache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#  include <process.h>
+#else
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+namespace libbase {
+
+namespace {
+
+//! Identifies a table file (and the byte order it was written in)
+const char magic[8] = {'S', 'C', 'S', 'T', 'B', 'L', '0', '1'};
+
+//! Table file header
+struct header {
+   char magic[8];
+   int32s order; //!< Written as 0x01020304 in native byte order
+   int32s count; //!< Number of entries following
+};
+
+} // end unnamed namespace
+
+// Static members
+
+std::string tablecache::key;
+int tablecache::ordinal = 0;
+std::string tablecache::pending;
+
+// Internal functions
+
+std::string tablecache::directory()
+   {
+   const char* dir = getenv("SIMCOMMSYS_CACHE");
+   return (dir == NULL) ? std::string() : std::string(dir);
+   }
+
+/*! \brief Load a table from file, if it exists and has the expected size
+ */
+bool tablecache::loadfile(const std::string& fname, const int count,
+      std::vector<int>& table)
+   {
+   const size_t length = sizeof(header) + count * sizeof(int32s);
+#ifdef _WIN32
+   std::ifstream file(fname.c_str(), std::ios::in | std::ios::binary);
+   if (!file)
+      return false;
+   std::vector<char> buf(length);
+   file.read(&buf[0], length);
+   if (size_t(file.gcount()) != length || file.peek() != EOF)
+      return false;
+   const char* data = &buf[0];
+#else
+   const int fd = open(fname.c_str(), O_RDONLY);
+   if (fd < 0)
+      return false;
+   struct stat s;
+   if (fstat(fd, &s) != 0 || size_t(s.st_size) != length)
+      {
+      close(fd);
+      return false;
+      }
+   void* map = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED)
+      return false;
+   const char* data = static_cast<const char*> (map);
+#endif
+   header h;
+   std::memcpy(&h, data, sizeof(h));
+   const bool ok = std::memcmp(h.magic, magic, sizeof(magic)) == 0 && h.order
+         == 0x01020304 && h.count == count;
+   if (ok)
+      {
+      table.resize(count);
+      const int32s* entries = reinterpret_cast<const int32s*> (data
+            + sizeof(header));
+      for (int i = 0; i < count; i++)
+         table[i] = entries[i];
+      }
+#ifndef _WIN32
+   munmap(map, length);
+#endif
+   return ok;
+   }
+
+// Cache interface
+
+bool tablecache::lookup(const int count, std::vector<int>& table)
+   {
+   pending.clear();
+   if (key.empty())
+      return false;
+   const std::string dir = directory();
+   if (dir.empty())
+      return false;
+   std::ostringstream fname;
+   fname << dir << "/" << key << "-" << ordinal++ << ".tbl";
+   if (loadfile(fname.str(), count, table))
+      {
+      trace << "DEBUG (tablecache): loaded " << fname.str() << std::endl;
+      return true;
+      }
+   pending = fname.str();
+   return false;
+   }
+
+void tablecache::store(const std::vector<int>& table)
+   {
+   if (pending.empty())
+      return;
+   // write to a file name unique to this process, then move into place
+   std::ostringstream tmpname;
+#ifdef _WIN32
+   tmpname << pending << "." << _getpid();
+#else
+   tmpname << pending << "." << getpid();
+#endif
+   header h;
+   std::memcpy(h.magic, magic, sizeof(magic));
+   h.order = 0x01020304;
+   h.count = int32s(table.size());
+   std::vector<int32s> entries(table.begin(), table.end());
+      {
+      std::ofstream file(tmpname.str().c_str(), std::ios::out
+            | std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*> (&h), sizeof(h));
+      if (!entries.empty())
+         file.write(reinterpret_cast<const char*> (&entries[0]),
+               entries.size() * sizeof(int32s));
+      file.close();
+      if (!file.good())
+         {
+         // the cache is only an optimization, so failure is not an error
+         std::remove(tmpname.str().c_str());
+         pending.clear();
+         return;
+         }
+      }
+   // if this fails (eg on Windows, where rename does not replace an existing
+   // file) another process got there first, and its copy is just as good
+   if (std::rename(tmpname.str().c_str(), pending.c_str()) != 0)
+      std::remove(tmpname.str().c_str());
+   trace << "DEBUG (tablecache): stored " << pending << std::endl;
+   pending.clear();
+   }
+
+void tablecache::skip(std::istream& sin, const int count, const int width)
+   {
+   std::streambuf* sb = sin.rdbuf();
+   for (int i = 0; i < count; i++)
+      {
+      // skip whitespace and comments
+      int c = sb->sgetc();
+      while (c != EOF && (isspace(c) || c == '#'))
+         {
+         if (c == '#')
+            while (c != EOF && c != '\n')
+               c = sb->snextc();
+         else
+            c = sb->snextc();
+         }
+      if (c == EOF)
+         {
+         sin.setstate(std::ios::eofbit | std::ios::failbit);
+         return;
+         }
+      // skip token
+      for (int k = 0; c != EOF && !isspace(c) && (width == 0 || k < width); k++)
+         c = sb->snextc();
+      }
+   }
+
+void tablecache::read(std::istream& sin, const int count, std::vector<int>& table)
+   {
+   if (lookup(count, table))
+      {
+      skip(sin, count);
+      return;
+      }
+   table.resize(count);
+   for (int i = 0; i < count; i++)
+      sin >> eatcomments >> table[i] >> verify;
+   store(table);
+   }
+
+void tablecache::read(std::istream& sin, vector<int>& x)
+   {
+   int count;
+   sin >> eatcomments >> count >> verify;
+   assertalways(count >= 0);
+   std::vector<int> table;
+   read(sin, count, table);
+   verify(sin);
+   x.init(count);
+   for (int i = 0; i < count; i++)
+      x(i) = table[i];
+   }
+
+} // end namespace
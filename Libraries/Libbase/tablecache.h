@@ -0,0 +1,126 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __tablecache_h
+#define __tablecache_h
+
+#include "config.h"
+#include "vector.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace libbase {
+
+/*!
+ * \brief   Binary Cache for Tables in System Files.
+ * \author  Johann Briffa
+ *
+ * Large tables in serialized systems (such as interleaver LUTs, parity-check
+ * matrix structure, or user codebooks) are slow to parse as text. This
+ * cache keeps such tables in binary form, in a node-local directory, so that
+ * loading the same system again (eg on each slave process on a node) only
+ * needs to skip over the text representation.
+ *
+ * The cache is content-addressed: a key (normally the digest of the whole
+ * system string) is set for the duration of a system's deserialization,
+ * and each table read is identified by this key and the order in which it
+ * is read. The same system string always produces the same tables in the
+ * same order, so cached tables never need validating against the text.
+ *
+ * Each table is stored in its own file, as a short header followed by the
+ * raw integers, and is memory-mapped for loading where supported (so the
+ * operating system shares cached pages between processes). Files are
+ * written to a temporary name and then renamed, so concurrent processes
+ * never see a partial table.
+ *
+ * The cache is used only if the environment variable SIMCOMMSYS_CACHE
+ * gives the cache directory, and only while a key is set; otherwise all
+ * lookups miss and nothing is stored.
+ *
+ * \note The cache key and read order are global, so systems using the cache
+ * should be deserialized by one thread at a time.
+ */
+
+class tablecache {
+private:
+   /*! \name Internal representation */
+   static std::string key; //!< Key of system being loaded (empty if none)
+   static int ordinal; //!< Number of tables read so far for this key
+   static std::string pending; //!< File for table to be stored after a miss
+   // @}
+private:
+   /*! \name Internal functions */
+   static std::string directory();
+   static bool loadfile(const std::string& fname, const int count,
+         std::vector<int>& table);
+   // @}
+public:
+   /*! \brief Scope within which tables are cached under the given key
+    * Tables are looked up and stored only while an object of this class
+    * exists; the key is cleared on destruction (including on exceptions).
+    */
+   class context {
+   public:
+      explicit context(const std::string& k)
+         {
+         key = k;
+         ordinal = 0;
+         pending.clear();
+         }
+      ~context()
+         {
+         key.clear();
+         pending.clear();
+         }
+   };
+
+   /*! \name Cache interface */
+   /*! \brief Look up the next table, of the given size
+    * On a hit, the table is returned and the caller should skip over its
+    * text representation. On a miss, the caller should parse the table and
+    * then call store().
+    * \return True if the table was found in the cache
+    */
+   static bool lookup(const int count, std::vector<int>& table);
+   //! Store the table for the last lookup that missed
+   static void store(const std::vector<int>& table);
+   /*! \brief Skip over 'count' tokens in the stream
+    * Tokens are separated by whitespace or comments; if 'width' is non-zero,
+    * tokens are also limited to that many characters (as for field elements
+    * written as binary digits).
+    */
+   static void skip(std::istream& sin, const int count, const int width = 0);
+   /*! \brief Read 'count' integers from the stream, or from the cache
+    * Integers are separated by whitespace or comments, as for reads through
+    * eatcomments.
+    */
+   static void read(std::istream& sin, const int count, std::vector<int>& table);
+   /*! \brief Read a vector of integers (its size, then the elements) from the
+    * stream, with the elements read through the cache
+    */
+   static void read(std::istream& sin, vector<int>& x);
+   // @}
+};
+
+} // end namespace
+
+#endif
@@ -40,10 +40,24 @@ namespace libcomm {
 template <class sig, class real, class real2>
 boost::shared_ptr<fba2_interface<sig, real, real2> > fba2_factory<sig, real,
       real2>::get_instance(bool fss, bool thresholding, bool lazy,
-      bool globalstore)
+      bool globalstore, bool checkpoint)
    {
    boost::shared_ptr<fba2_interface<sig, real, real2> > fba_ptr;
 
+   // checkpointed storage is a variant of global storage
+   assertalways(globalstore || !checkpoint);
+#ifdef USE_CUDA
+   const bool can_checkpoint = false;
+#else
+   const bool can_checkpoint = !fss;
+#endif
+   // fall back to local storage where checkpointing is not supported
+   if (checkpoint && !can_checkpoint)
+      {
+      globalstore = false;
+      checkpoint = false;
+      }
+
 #ifdef USE_CUDA
 #  define FBA_TYPE cuda::fba2
 #  define RECV_TYPE cuda::tvb_receiver<sig, real, real2>
@@ -85,6 +99,8 @@ boost::shared_ptr<fba2_interface<sig, real, real2> > fba2_factory<sig, real,
 #undef CONDITIONAL
 
    assertalways(fba_ptr);
+   if (checkpoint)
+      fba_ptr->set_checkpointing(true);
    return fba_ptr;
    }
 
@@ -37,6 +37,10 @@ namespace libcomm {
  * depending on compiler flags, and takes as parameters the flag values
  * (which are determined at runtime).
  *
+ * Checkpointed storage is only available with the CPU implementation of the
+ * generic (non-FSS) algorithm; elsewhere, a request for checkpointed storage
+ * falls back to local storage, which has similar memory requirements.
+ *
  * \tparam sig Channel symbol type
  * \tparam real Floating-point type for internal computation
  * \tparam real2 Floating-point type for receiver metric computation
@@ -47,7 +51,8 @@ class fba2_factory {
 public:
    //! Return an instance of the FBA2 algorithm
    static boost::shared_ptr<fba2_interface<sig, real, real2> > get_instance(
-         bool fss, bool thresholding, bool lazy, bool globalstore);
+         bool fss, bool thresholding, bool lazy, bool globalstore,
+         bool checkpoint = false);
 };
 
 } // end namespace
@@ -85,30 +85,32 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_a
    {
    // determine the strongest path at this point
    const real threshold = get_threshold(alpha, i - 1, mtau_min, mtau_max, th_inner);
-   for (int x1 = mtau_min; x1 <= mtau_max; x1++)
+   // NOTE: each end-state is computed independently (as in the CUDA kernel),
+   // accumulating over start-states in the same order as a forward loop
+#pragma omp parallel for if(!lazy)
+   for (int x2 = mtau_min; x2 <= mtau_max; x2++)
       {
-      // cache previous alpha value in a register
-      const real prev_alpha = alpha[i - 1][x1];
-      // ignore paths below a certain threshold
-      if (thresholding && prev_alpha < threshold)
-         continue;
+      real this_alpha = alpha[i][x2];
       // limits on deltax can be combined as (c.f. allocate() for details):
       //   x2-x1 <= mn_max
       //   x2-x1 >= mn_min
-      const int x2min = std::max(mtau_min, mn_min + x1);
-      const int x2max = std::min(mtau_max, mn_max + x1);
-      for (int x2 = x2min; x2 <= x2max; x2++)
+      const int x1min = std::max(mtau_min, x2 - mn_max);
+      const int x1max = std::min(mtau_max, x2 - mn_min);
+      for (int x1 = x1min; x1 <= x1max; x1++)
          {
-         // NOTE: we're repeating the loop on x2, so we need to increment this
-         real this_alpha = alpha[i][x2];
+         // cache previous alpha value in a register
+         const real prev_alpha = alpha[i - 1][x1];
+         // ignore paths below a certain threshold
+         if (thresholding && prev_alpha < threshold)
+            continue;
          for (int d = 0; d < q; d++)
             {
             real temp = prev_alpha;
             temp *= get_gamma(d, i - 1, x1, x2 - x1);
             this_alpha += temp;
             }
-         alpha[i][x2] = this_alpha;
          }
+      alpha[i][x2] = this_alpha;
       }
    }
 
@@ -117,6 +119,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_b
    {
    // determine the strongest path at this point
    const real threshold = get_threshold(beta, i + 1, mtau_min, mtau_max, th_inner);
+#pragma omp parallel for if(!lazy)
    for (int x1 = mtau_min; x1 <= mtau_max; x1++)
       {
       real this_beta = 0;
@@ -149,6 +152,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_m
    {
    // determine the strongest path at this point
    const real threshold = get_threshold(alpha, i, mtau_min, mtau_max, th_outer);
+#pragma omp parallel for if(!lazy)
    for (int d = 0; d < q; d++)
       {
       // initialize result holder
@@ -185,6 +189,13 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_s
    assert(i >= 0 && i <= N);
    // compute posterior probabilities for given index
    ptable.init(mtau_max - mtau_min + 1);
+   // in checkpointed mode these were kept during the backward pass
+   if (checkpoint)
+      {
+      for (int x = mtau_min; x <= mtau_max; x++)
+         ptable(x - mtau_min) = state_app[i][x];
+      return;
+      }
    for (int x = mtau_min; x <= mtau_max; x++)
       ptable(x - mtau_min) = alpha[i][x] * beta[i][x];
    }
@@ -201,11 +212,38 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::alloca
    // flag the state of the arrays
    initialised = true;
 
+   /* In checkpointed mode, alpha, beta, and gamma (with its cache flags)
+    * only cover a single segment; in this case index 'i' below is offset
+    * to the start of the current segment (c.f. set_segment_base()), and
+    * its range is limited to the segment length.
+    */
+   if (checkpoint)
+      segment = int(ceil(sqrt(double(N))));
+   const int length = checkpoint ? segment : N;
+
    // alpha needs indices (i,x) where i in [0, N] and x in [mtau_min, mtau_max]
    // beta needs indices (i,x) where i in [0, N] and x in [mtau_min, mtau_max]
    typedef boost::multi_array_types::extent_range range;
-   alpha.resize(boost::extents[N + 1][range(mtau_min, mtau_max + 1)]);
-   beta.resize(boost::extents[N + 1][range(mtau_min, mtau_max + 1)]);
+   alpha.resize(boost::extents[length + 1][range(mtau_min, mtau_max + 1)]);
+   beta.resize(boost::extents[length + 1][range(mtau_min, mtau_max + 1)]);
+   if (checkpoint)
+      {
+      /* alpha_checkpoint needs indices (k,x) where
+       * k in [0, K-1] is the segment index
+       * x in [mtau_min, mtau_max]
+       * state_app needs indices (i,x) where
+       * i in [0, N]
+       * x in [mtau_min, mtau_max]
+       */
+      alpha_checkpoint.resize(
+            boost::extents[get_segments()][range(mtau_min, mtau_max + 1)]);
+      state_app.resize(boost::extents[N + 1][range(mtau_min, mtau_max + 1)]);
+      }
+   else
+      {
+      alpha_checkpoint.resize(boost::extents[0][0]);
+      state_app.resize(boost::extents[0][0]);
+      }
 
    if (globalstore)
       {
@@ -216,7 +254,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::alloca
        * deltax in [mn_min, mn_max]
        */
       gamma.global.resize(
-            boost::extents[N][range(mtau_min, mtau_max + 1)][q][range(mn_min, mn_max + 1)]);
+            boost::extents[length][range(mtau_min, mtau_max + 1)][q][range(mn_min, mn_max + 1)]);
       gamma.local.resize(boost::extents[0][0][0]);
       }
    else
@@ -239,7 +277,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::alloca
           * i in [0, N-1]
           * x in [mtau_min, mtau_max]
           */
-         cached.global.resize(boost::extents[N][range(mtau_min, mtau_max + 1)]);
+         cached.global.resize(boost::extents[length][range(mtau_min, mtau_max + 1)]);
          cached.local.resize(boost::extents[0]);
          }
       else
@@ -274,6 +312,8 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::alloca
    bytes_used += sizeof(bool) * cached.local.num_elements();
    bytes_used += sizeof(real) * alpha.num_elements();
    bytes_used += sizeof(real) * beta.num_elements();
+   bytes_used += sizeof(real) * alpha_checkpoint.num_elements();
+   bytes_used += sizeof(real) * state_app.num_elements();
    bytes_used += sizeof(real) * gamma.global.num_elements();
    bytes_used += sizeof(real) * gamma.local.num_elements();
    std::cerr << "FBA Memory Usage: " << bytes_used / double(1 << 20) << "MiB"
@@ -322,6 +362,8 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::free()
    {
    alpha.resize(boost::extents[0][0]);
    beta.resize(boost::extents[0][0]);
+   alpha_checkpoint.resize(boost::extents[0][0]);
+   state_app.resize(boost::extents[0][0]);
    gamma.global.resize(boost::extents[0][0][0][0]);
    gamma.local.resize(boost::extents[0][0][0]);
    cached.global.resize(boost::extents[0][0]);
@@ -373,6 +415,24 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::print_
       }
    }
 
+/*! \brief Move the segment-sized arrays to start at index i0
+ * This is used in checkpointed mode only; the arrays are re-indexed in place,
+ * without moving their contents.
+ */
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::set_segment_base(int i0)
+   {
+   assert(checkpoint);
+   typedef boost::multi_array_types::index index;
+   const boost::array<index, 2> base2 = { { i0, mtau_min } };
+   const boost::array<index, 4> base4 = { { i0, mtau_min, 0, mn_min } };
+   alpha.reindex(base2);
+   beta.reindex(base2);
+   gamma.global.reindex(base4);
+   if (lazy)
+      cached.global.reindex(base2);
+   }
+
 // decode functions - global path
 
 template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
@@ -448,9 +508,13 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_r
    // Initialise result vector:
    // ptable(i,d) = posterior prob. of having transmitted symbol 'd' at time 'i'
    libbase::allocate(ptable, N, q);
+   // NOTE: each index is independent, so these can be done in parallel;
+   // progress is not shown per index in this case
+#pragma omp parallel for schedule(dynamic) if(!lazy)
    for (int i = 0; i < N; i++)
       {
-      std::cerr << progress.update(i, N);
+      if (lazy)
+         std::cerr << progress.update(i, N);
       // compute partial result
       work_message_app(ptable, i);
       }
@@ -562,6 +626,142 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_b
 #endif
    }
 
+// decode functions - checkpointed path
+
+/*! \brief Recompute the forward metric within segment 'k'
+ * Starting from the stored checkpoint, this fills alpha for the whole segment,
+ * together with the gamma values for the segment (pre-computed or cached,
+ * as applicable).
+ */
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_segment_alpha(const int k)
+   {
+   const int i0 = k * segment;
+   const int i1 = std::min(i0 + segment, N);
+   // move segment storage to this segment
+   set_segment_base(i0);
+   if (!lazy)
+      {
+      // pre-compute gamma values for this segment
+      for (int i = i0; i < i1; i++)
+         work_gamma(r, app, i);
+      }
+   else
+      {
+      // reset segment cache
+      gamma.global = real(0);
+      cached.global = false;
+      }
+   // initialise array and restore checkpoint
+   alpha = real(0);
+   for (int x = mtau_min; x <= mtau_max; x++)
+      alpha[i0][x] = alpha_checkpoint[k][x];
+   // compute remaining matrix values
+   for (int i = i0 + 1; i <= i1; i++)
+      {
+      // compute partial result
+      work_alpha(i);
+      // normalize
+      normalize_alpha(i);
+      }
+   }
+
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_alpha_checkpointed(
+      const array1d_t& sof_prior)
+   {
+   assert(initialised);
+   libbase::pacifier progress("FBA Alpha");
+   // set initial drift distribution
+   for (int x = mtau_min; x <= mtau_max; x++)
+      alpha_checkpoint[0][x] = real(sof_prior(x - mtau_min));
+   // normalize
+   normalize(alpha_checkpoint, 0, mtau_min, mtau_max);
+   // compute each segment in turn, keeping the checkpoint for the next one
+   const int K = get_segments();
+   for (int k = 0; k < K; k++)
+      {
+      std::cerr << progress.update(k, K);
+      work_segment_alpha(k);
+      if (k + 1 < K)
+         for (int x = mtau_min; x <= mtau_max; x++)
+            alpha_checkpoint[k + 1][x] = alpha[(k + 1) * segment][x];
+      }
+   std::cerr << progress.update(K, K);
+#if DEBUG>=3
+   std::cerr << "alpha_checkpoint = " << alpha_checkpoint << std::endl;
+#endif
+   }
+
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_beta_and_results_checkpointed(
+      const array1d_t& eof_prior, array1vr_t& ptable, array1r_t& sof_post,
+      array1r_t& eof_post)
+   {
+   assert(initialised);
+   libbase::pacifier progress("FBA Beta + Results");
+   // Initialise result vector:
+   // ptable(i,d) = posterior prob. of having transmitted symbol 'd' at time 'i'
+   libbase::allocate(ptable, N, q);
+   // beta values at the start of the segment last computed
+   array1r_t beta_next(mtau_max - mtau_min + 1);
+   // compute each segment in turn, in reverse order
+   const int K = get_segments();
+   for (int k = K - 1; k >= 0; k--)
+      {
+      std::cerr << progress.update(K - 1 - k, K);
+      const int i0 = k * segment;
+      const int i1 = std::min(i0 + segment, N);
+      if (k == K - 1)
+         {
+         // the last segment is still in place from the forward pass
+         // initialise array:
+         // NOTE: technically unnecessary, as we initialize this_beta for every value
+         beta = real(0);
+         // set final drift distribution
+         for (int x = mtau_min; x <= mtau_max; x++)
+            beta[N][x] = real(eof_prior(x - mtau_min));
+         // normalize
+         normalize_beta(N);
+         }
+      else
+         {
+         // recompute alpha (and gamma) for this segment
+         work_segment_alpha(k);
+         // initialise array and restore starting values from next segment
+         beta = real(0);
+         for (int x = mtau_min; x <= mtau_max; x++)
+            beta[i1][x] = beta_next(x - mtau_min);
+         }
+      // compute remaining matrix values
+      for (int i = i1 - 1; i >= i0; i--)
+         {
+         // compute partial result
+         work_beta(i);
+         // normalize
+         normalize_beta(i);
+         // compute partial result
+         work_message_app(ptable, i);
+         }
+      // keep drift posteriors for this segment
+      for (int i = i0; i <= i1; i++)
+         for (int x = mtau_min; x <= mtau_max; x++)
+            state_app[i][x] = alpha[i][x] * beta[i][x];
+      // keep starting beta values for the previous segment
+      for (int x = mtau_min; x <= mtau_max; x++)
+         beta_next(x - mtau_min) = beta[i0][x];
+      }
+   std::cerr << progress.update(K, K);
+   // compute APPs of sof/eof state values
+   work_state_app(sof_post, 0);
+   work_state_app(eof_post, N);
+#if DEBUG>=3
+   std::cerr << "ptable = " << ptable << std::endl;
+   std::cerr << "sof_post = " << sof_post << std::endl;
+   std::cerr << "eof_post = " << eof_post << std::endl;
+#endif
+   }
+
 // User procedures
 
 // Initialization
@@ -671,7 +871,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::decode
    assertalways(eof_prior.size() == mtau_max - mtau_min + 1);
 
    // Gamma
-   if (!lazy && globalstore)
+   if (!lazy && globalstore && !checkpoint)
       {
       // compute immediately for global pre-compute mode
       libbase::cputimer tg("t_gamma");
@@ -689,7 +889,19 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::decode
          reset_cache();
       }
    // Alpha + Beta + Results
-   if (globalstore)
+   if (checkpoint)
+      {
+      // Alpha (keeping checkpoints only)
+      libbase::cputimer ta("t_alpha");
+      work_alpha_checkpointed(sof_prior);
+      collector.add_timer(ta);
+      // Beta + Results (recomputing each segment)
+      libbase::cputimer tbr("t_beta+results");
+      work_beta_and_results_checkpointed(eof_prior, ptable, sof_post,
+            eof_post);
+      collector.add_timer(tbr);
+      }
+   else if (globalstore)
       {
       // Alpha + Beta
       libbase::cputimer tab("t_alpha+beta");
@@ -720,8 +932,8 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::decode
    collector.add_timer(m1_min, "c_m1_min");
    collector.add_timer(m1_max, "c_m1_max");
    // Add memory usage
-   collector.add_timer(sizeof(real) * alpha.num_elements(), "m_alpha");
-   collector.add_timer(sizeof(real) * beta.num_elements(), "m_beta");
+   collector.add_timer(sizeof(real) * (alpha.num_elements() + alpha_checkpoint.num_elements()), "m_alpha");
+   collector.add_timer(sizeof(real) * (beta.num_elements() + state_app.num_elements()), "m_beta");
    collector.add_timer(sizeof(real) * (gamma.global.num_elements() + gamma.local.num_elements()), "m_gamma");
 
 #ifndef NDEBUG
@@ -93,6 +93,18 @@ public:
          array1r_t& eof_post, const int offset) = 0;
    virtual void get_drift_pdf(array1r_t& pdf, const int i) const = 0;
    virtual void get_drift_pdf(array1vr_t& pdftable) const = 0;
+   /*! \brief Select checkpointed storage mode
+    * In this mode the forward metric is kept only at segment boundaries,
+    * and segments are recomputed during the backward pass, so that the
+    * gamma metric needs to be stored for one segment at a time. This is
+    * only meaningful for global storage, and needs to be done before init().
+    * Implementations that do not support this mode fail if it is requested.
+    */
+   virtual void set_checkpointing(bool checkpoint)
+      {
+      if (checkpoint)
+         failwith("Checkpointed storage not supported by this implementation");
+      }
 
    //! Description
    virtual std::string description() const = 0;
@@ -50,6 +50,18 @@ namespace libcomm {
  * \tparam thresholding Flag to indicate if we're doing path thresholding
  * \tparam lazy Flag indicating lazy computation of gamma metric
  * \tparam globalstore Flag indicating global pre-computation or caching of gamma values
+ *
+ * With global storage, a checkpointed mode may be selected at runtime; this
+ * keeps the forward metric only at the start of each segment of
+ * \f$ \lceil \sqrt{N} \rceil \f$ codewords, and recomputes each segment
+ * during the backward pass. Gamma values are then stored (or cached) for one
+ * segment at a time, so that memory usage grows with \f$ \sqrt{N} \f$ rather
+ * than \f$ N \f$.
+ *
+ * When compiled with OpenMP, the inner loops are split across threads in the
+ * same way as the CUDA implementation splits them across GPU threads; this is
+ * only done for pre-computed gamma values, as lazy computation updates a
+ * shared cache.
  */
 
 template <class receiver_t, class sig, class real, class real2,
@@ -75,6 +87,8 @@ private:
    mutable receiver_t receiver; //!< Inner code receiver metric computation
    array2r_t alpha; //!< Forward recursion metric
    array2r_t beta; //!< Backward recursion metric
+   array2r_t alpha_checkpoint; //!< Forward metric at segment starts (checkpointed mode)
+   array2r_t state_app; //!< Drift posteriors at codeword boundaries (checkpointed mode)
    mutable struct {
       array4r_t global; // indices (i,x,d,deltax)
       array3r_t local; // indices (x,d,deltax)
@@ -89,6 +103,8 @@ private:
    array1s_t r; //!< Copy of received sequence, for lazy or local computation of gamma
    array1vd_t app; //!< Copy of a-priori statistics, for lazy or local computation of gamma
    bool initialised; //!< Flag to indicate when memory is allocated
+   bool checkpoint; //!< Flag to indicate checkpointed storage (global storage only)
+   int segment; //!< Number of codewords in each checkpointed segment
 #ifndef NDEBUG
    mutable int gamma_calls; //!< Number of calls requesting gamma values
    mutable int gamma_misses; //!< Number of cache misses in such calls
@@ -120,8 +136,8 @@ private:
    void fill_gamma_storage_batch(const array1s_t& r, const array1vd_t& app, int i, int x) const
       {
       // allocate space for results
-      static array1r_t ptable;
-      ptable.init(mn_max - mn_min + 1);
+      // NOTE: this is local as we may be called from parallel threads
+      array1r_t ptable(mn_max - mn_min + 1);
       // determine received segment to extract
       // n * i = offset to start of current codeword
       // -mtau_min = offset to zero drift in 'r'
@@ -207,10 +223,17 @@ private:
       {
       normalize(beta, i, mtau_min, mtau_max);
       }
+   //! Number of segments in checkpointed mode
+   int get_segments() const
+      {
+      return (N + segment - 1) / segment;
+      }
    // decode functions - partial computations
    void work_gamma(const array1s_t& r, const array1vd_t& app,
          const int i) const
       {
+      // NOTE: this mirrors the CUDA gamma kernel, with one thread per 'x'
+#pragma omp parallel for schedule(dynamic)
       for (int x = mtau_min; x <= mtau_max; x++)
          fill_gamma_storage_batch(r, app, i, x);
       }
@@ -227,6 +250,7 @@ private:
    // helper methods
    void reset_cache() const;
    void print_gamma(std::ostream& sout) const;
+   void set_segment_base(int i0);
    // decode functions - global path
    void work_gamma(const array1s_t& r, const array1vd_t& app);
    void work_alpha_and_beta(const array1d_t& sof_prior,
@@ -237,12 +261,17 @@ private:
    void work_alpha(const array1d_t& sof_prior);
    void work_beta_and_results(const array1d_t& eof_prior, array1vr_t& ptable,
          array1r_t& sof_post, array1r_t& eof_post);
+   // decode functions - checkpointed path
+   void work_segment_alpha(const int k);
+   void work_alpha_checkpointed(const array1d_t& sof_prior);
+   void work_beta_and_results_checkpointed(const array1d_t& eof_prior,
+         array1vr_t& ptable, array1r_t& sof_post, array1r_t& eof_post);
    // @}
 public:
    /*! \name Constructors / Destructors */
    //! Default constructor
    fba2() :
-         initialised(false)
+         initialised(false), checkpoint(false)
       {
       }
    // @}
@@ -285,6 +314,14 @@ public:
       work_state_app(pdf, i);
       }
    void get_drift_pdf(array1vr_t& pdftable) const;
+   void set_checkpointing(bool checkpoint)
+      {
+      assertalways(globalstore || !checkpoint);
+      // release memory if the storage layout changes
+      if (initialised && checkpoint != this->checkpoint)
+         free();
+      this->checkpoint = checkpoint;
+      }
 
    //! Description
    std::string description() const
@@ -21,6 +21,8 @@
 
 #include "annealer.h"
 #include <cmath>
+#include <vector>
+#include <algorithm>
 #include <iostream>
 
 namespace libcomm {
@@ -33,6 +35,7 @@ void annealer::attach_system(boost::shared_ptr<anneal_system> system)
    set_temperature(E, E * 1E-7);
    set_schedule(0.90);
    set_iterations(int(1E5), int(1E3));
+   set_replicas(1);
    }
 
 void annealer::seedfrom(libbase::random& r)
@@ -58,11 +61,30 @@ void annealer::set_iterations(const int min_iter, const int min_changes)
    this->min_changes = min_changes;
    }
 
+void annealer::set_replicas(const int replicas)
+   {
+   assertalways(replicas >= 1);
+   this->replicas = replicas;
+   }
+
 void annealer::improve()
    {
    // set stderr to precision 4
    std::streamsize prec = std::clog.precision(4);
 
+   if (replicas > 1)
+      improve_tempering();
+   else
+      improve_single();
+
+   // revert stderr to original precision
+   std::clog.precision(prec);
+   }
+
+// Internal functions
+
+void annealer::improve_single()
+   {
    // 'E' holds the instantaneous system energy
    // 'stability' denotes the number of successive steps for which system did not change
    double E = system->energy();
@@ -97,9 +119,93 @@ void annealer::improve()
       // output some statistics for the user
       display(T, 100 * double(c) / double(i), stat);
       }
+   }
 
-   // revert stderr to original precision
-   std::clog.precision(prec);
+/*!
+ * \brief Parallel tempering
+ * Replica 'k' is held at temperature T(k) = Tstop.(Tstart/Tstop)^(k/(R-1)),
+ * so that replica 0 is the coldest. Each round runs a chain of the same
+ * length as one temperature step of the single-chain schedule on every
+ * replica, after which adjacent pairs (alternating between even and odd
+ * pairs) exchange states with the usual Metropolis probability
+ * min(1, exp((1/T_k - 1/T_{k+1})(E_k - E_{k+1}))). The number of rounds is
+ * the number of steps in the single-chain schedule, so that the same number
+ * of perturbations is tried by each replica.
+ */
+void annealer::improve_tempering()
+   {
+   const int R = replicas;
+   // set up replicas, temperatures, and per-replica generators
+   std::vector<boost::shared_ptr<anneal_system> > rep(R);
+   std::vector<libbase::randgen> rg(R);
+   std::vector<double> T(R), E(R);
+   std::vector<int> changes(R), tries(R);
+   for (int k = 0; k < R; k++)
+      {
+      rep[k] = boost::shared_ptr<anneal_system>(system->clone());
+      rep[k]->seedfrom(r);
+      rg[k].seed(r.ival());
+      T[k] = Tstop * pow(Tstart / Tstop, double(k) / double(R - 1));
+      E[k] = rep[k]->energy();
+      }
+   boost::shared_ptr<anneal_system> best(system->clone());
+   double Ebest = E[0];
+   // number of rounds matches the number of steps of the normal schedule
+   const int rounds = std::max(1, int(ceil(log(Tstop / Tstart) / log(rate))));
+   int stability = 0;
+   for (int round = 0; round < rounds && stability < 5; round++)
+      {
+      // run a chain on each replica at its own temperature
+#pragma omp parallel for schedule(dynamic)
+      for (int k = 0; k < R; k++)
+         {
+         int i, c;
+         for (i = 0, c = 0; i < min_iter && c < min_changes; i++)
+            {
+            double deltaE = rep[k]->perturb();
+            if (deltaE < 0 || rg[k].fval_closed() < exp(-deltaE / T[k]))
+               {
+               c++;
+               E[k] += deltaE;
+               }
+            else
+               rep[k]->unperturb();
+            }
+         changes[k] = c;
+         tries[k] = i;
+         }
+      // keep track of the best state seen
+      libbase::rvstatistics stat;
+      for (int k = 0; k < R; k++)
+         {
+         stat.insert(E[k]);
+         if (E[k] < Ebest)
+            {
+            Ebest = E[k];
+            best->assign(*rep[k]);
+            }
+         }
+      if (interrupt())
+         break;
+      // exchange states between adjacent temperatures
+      for (int k = round & 1; k + 1 < R; k += 2)
+         {
+         const double a = (1 / T[k] - 1 / T[k + 1]) * (E[k] - E[k + 1]);
+         if (a >= 0 || r.fval_closed() < exp(a))
+            {
+            std::swap(rep[k], rep[k + 1]);
+            std::swap(E[k], E[k + 1]);
+            }
+         }
+      // check for stability of the coldest replica
+      if (changes[0] == 0)
+         stability++;
+      else
+         stability = 0;
+      // output some statistics for the user
+      display(T[0], 100 * double(changes[0]) / double(tries[0]), stat);
+      }
+   system->assign(*best);
    }
 
 void annealer::display(const double T, const double percent,
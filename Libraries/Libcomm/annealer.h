@@ -54,6 +54,13 @@ namespace libcomm {
  * \version 1.10 (27 Oct 2006)
  * - defined class and associated data within "libcomm" namespace.
  * - removed use of "using namespace std", replacing by tighter "using" statements as needed.
+ *
+ * \version 1.20
+ * added parallel tempering: when more than one replica is requested, copies
+ * of the system are annealed at fixed temperatures spaced geometrically
+ * between Tstop and Tstart, with replicas at adjacent temperatures exchanged
+ * after each round; the best state found by any replica is kept. Replicas
+ * run concurrently when OpenMP is available.
  */
 
 class annealer {
@@ -62,7 +69,10 @@ protected:
    libbase::randgen r;
    double Tstart, Tstop, rate;
    int min_iter, min_changes;
+   int replicas;
 protected:
+   void improve_single();
+   void improve_tempering();
    virtual ~annealer()
       {
       }
@@ -78,6 +88,7 @@ public:
    void set_temperature(const double Tstart, const double Tstop);
    void set_schedule(const double rate);
    void set_iterations(const int min_iter, const int min_changes);
+   void set_replicas(const int replicas);
    void improve();
 };
 
@@ -58,6 +58,10 @@ namespace libcomm {
  * \version 1.30 (27 Oct 2006)
  * - defined class and associated data within "libcomm" namespace.
  * - removed use of "using namespace std", replacing by tighter "using" statements as needed.
+ *
+ * \version 1.40
+ * added cloning and state assignment, needed to run several replicas of a
+ * system (as in parallel tempering)
  */
 
 class anneal_system {
@@ -73,6 +77,10 @@ public:
    virtual void unperturb() = 0;
    //! Returns the system's energy content
    virtual double energy() = 0;
+   //! Creates an independent copy of the system, in its current state
+   virtual anneal_system* clone() const = 0;
+   //! Sets the state to that of another system (which must be of the same type)
+   virtual void assign(const anneal_system& x) = 0;
    //! Outputs the system to an output stream
    virtual std::ostream& output(std::ostream& sout) const = 0;
    friend std::ostream& operator<<(std::ostream& sout, const anneal_system& x);
@@ -36,6 +36,8 @@ anneal_interleaver::anneal_interleaver(const int sets, const int tau,
    anneal_interleaver::m = m;
    anneal_interleaver::type = type;
    anneal_interleaver::term = term || (type <= 7);
+   // single-set energy types 2-6 vanish for input distances beyond 5m
+   reach = (sets < 2 && type >= 2 && type <= 6) ? std::min(5 * m, tau) : tau;
    // compute useful functions
    f0 = tau * sqrt(double(2));
    f1 = tau * sqrt(double(2)) / 2;
@@ -179,17 +181,29 @@ double anneal_interleaver::work_energy()
    {
    double energy = 0;
    for (int i = 0; i < tau; i++)
-      for (int j = i + 1; j < tau; j++)
+      for (int j = i + 1; j < tau && j <= i + reach; j++)
          energy += energy_function(i, j);
    return energy;
    }
 
+/*!
+ * \brief Energy of the terms involving positions pos1 or pos2
+ * Only positions within the reach of each are visited; the term between
+ * pos1 and pos2 is excluded as it does not change on swapping.
+ */
 double anneal_interleaver::work_delta()
    {
    double delta = 0;
-   for (int i = 0; i < tau; i++)
+   const int lo1 = std::max(0, pos1 - reach);
+   const int hi1 = std::min(tau - 1, pos1 + reach);
+   for (int i = lo1; i <= hi1; i++)
+      if (i != pos1 && i != pos2)
+         delta += energy_function(pos1, i);
+   const int lo2 = std::max(0, pos2 - reach);
+   const int hi2 = std::min(tau - 1, pos2 + reach);
+   for (int i = lo2; i <= hi2; i++)
       if (i != pos1 && i != pos2)
-         delta += energy_function(pos1, i) + energy_function(pos2, i);
+         delta += energy_function(pos2, i);
    return delta;
    }
 
@@ -121,6 +121,11 @@ namespace libcomm {
  *
  * \version 3.31 (2 Jan 2008)
  * - modified stream output to include only LUT contents, not index
+ *
+ * \version 3.40
+ * - for energy types that vanish beyond an input distance of 5m (types 2-6),
+ * energy and delta computations only visit positions within that distance
+ * - added cloning and state assignment, in accordance with anneal_system 1.40
  */
 
 class anneal_interleaver : public virtual anneal_system {
@@ -128,6 +133,7 @@ class anneal_interleaver : public virtual anneal_system {
    libbase::randgen r;
    bool term;
    int sets, tau, m, type;
+   int reach; //!< Largest input distance at which energy terms are non-zero
    double f0, f1, f2;
    double E, Eold;
    int set, pos1, pos2;
@@ -151,6 +157,15 @@ public:
    double perturb();
    void unperturb();
    double energy();
+   // replica support
+   anneal_system* clone() const
+      {
+      return new anneal_interleaver(*this);
+      }
+   void assign(const anneal_system& x)
+      {
+      *this = dynamic_cast<const anneal_interleaver&> (x);
+      }
    // output the system
    std::ostream& output(std::ostream& sout) const;
 };
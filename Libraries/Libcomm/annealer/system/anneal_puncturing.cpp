@@ -29,6 +29,7 @@ anneal_puncturing::anneal_puncturing(const char *fname, const int tau,
       const int s)
    {
    // store user parameters
+   report = true;
    anneal_puncturing::tau = tau;
    anneal_puncturing::s = s;
    // initialise contribution matrix and load contribution matrix from file
@@ -74,7 +75,22 @@ anneal_puncturing::anneal_puncturing(const char *fname, const int tau,
 
 anneal_puncturing::~anneal_puncturing()
    {
-   output(std::cout);
+   if (report)
+      output(std::cout);
+   }
+
+anneal_system* anneal_puncturing::clone() const
+   {
+   anneal_puncturing *copy = new anneal_puncturing(*this);
+   copy->report = false;
+   return copy;
+   }
+
+void anneal_puncturing::assign(const anneal_system& x)
+   {
+   const bool keep = report;
+   *this = dynamic_cast<const anneal_puncturing&> (x);
+   report = keep;
    }
 
 inline void anneal_puncturing::energy_function(const double factor,
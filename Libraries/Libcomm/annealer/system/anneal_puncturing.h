@@ -62,6 +62,10 @@ namespace libcomm {
  * \version 1.20 (27 Oct 2006)
  * - defined class and associated data within "libcomm" namespace.
  * - removed use of "using namespace std", replacing by tighter "using" statements as needed.
+ *
+ * \version 1.30
+ * added cloning and state assignment, in accordance with anneal_system 1.40;
+ * only the original system outputs its pattern on destruction, not clones.
  */
 
 class anneal_puncturing : public virtual anneal_system {
@@ -72,6 +76,7 @@ class anneal_puncturing : public virtual anneal_system {
    int tau, s;
    double E, Eold;
    int set, pos1, pos2;
+   bool report; //!< Whether to output the pattern on destruction
 protected:
    void energy_function(const double factor, const int set, const int pos);
    double work_energy();
@@ -87,6 +92,9 @@ public:
    double perturb();
    void unperturb();
    double energy();
+   // replica support
+   anneal_system* clone() const;
+   void assign(const anneal_system& x);
    // output the system
    std::ostream& output(std::ostream& sout) const;
 };
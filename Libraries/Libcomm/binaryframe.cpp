@@ -0,0 +1,316 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binaryframe.h"
+#include <cmath>
+#include <cstring>
+
+#ifndef _WIN32
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+namespace libcomm {
+
+// *** binaryframe ***
+
+const libbase::int32s binaryframe::magic = 0x31464353; // "SCF1" little-endian
+
+int binaryframe::components(const header& h)
+   {
+   switch (h.symbol)
+      {
+      case symbol_integer:
+         return 1;
+      case symbol_sigspace:
+         return 2;
+      case symbol_probability:
+         return h.alphabet;
+      default:
+         failwith("Unknown symbol representation in binary frame");
+      }
+   return 0;
+   }
+
+int binaryframe::value_bytes(const int payload)
+   {
+   switch (payload)
+      {
+      case payload_int32:
+         return 4;
+      case payload_float32:
+         return 4;
+      case payload_float64:
+         return 8;
+      case payload_llr8:
+         return 1;
+      default:
+         failwith("Unknown payload type in binary frame");
+      }
+   return 0;
+   }
+
+binaryframe::payload_t binaryframe::payload_from_name(const std::string& name)
+   {
+   if (name == "int32")
+      return payload_int32;
+   else if (name == "float")
+      return payload_float32;
+   else if (name == "double")
+      return payload_float64;
+   else if (name == "llr8")
+      return payload_llr8;
+   failwith("Unrecognized payload type: " + name);
+   return payload_float64;
+   }
+
+void binaryframe::decode(const header& h, const char* src, double* dst,
+      const size_t n)
+   {
+   switch (h.payload)
+      {
+      case payload_int32:
+         {
+         libbase::int32s v;
+         for (size_t i = 0; i < n; i++)
+            {
+            std::memcpy(&v, src + 4 * i, 4);
+            dst[i] = v;
+            }
+         }
+         break;
+      case payload_float32:
+         {
+         float v;
+         for (size_t i = 0; i < n; i++)
+            {
+            std::memcpy(&v, src + 4 * i, 4);
+            dst[i] = v;
+            }
+         }
+         break;
+      case payload_float64:
+         std::memcpy(dst, src, 8 * n);
+         break;
+      case payload_llr8:
+         {
+         assertalways(h.kind == kind_ptable);
+         // tabulate the 256 possible values
+         double table[256];
+         for (int c = 0; c < 256; c++)
+            table[c] = exp(-c * double(h.scale));
+         for (size_t i = 0; i < n; i++)
+            dst[i] = table[libbase::int8u(src[i])];
+         }
+         break;
+      default:
+         failwith("Unknown payload type in binary frame");
+      }
+   }
+
+void binaryframe::encode(const header& h, const double* src, char* dst,
+      const size_t n)
+   {
+   switch (h.payload)
+      {
+      case payload_int32:
+         for (size_t i = 0; i < n; i++)
+            {
+            const libbase::int32s v = libbase::int32s(src[i]);
+            std::memcpy(dst + 4 * i, &v, 4);
+            }
+         break;
+      case payload_float32:
+         for (size_t i = 0; i < n; i++)
+            {
+            const float v = float(src[i]);
+            std::memcpy(dst + 4 * i, &v, 4);
+            }
+         break;
+      case payload_float64:
+         std::memcpy(dst, src, 8 * n);
+         break;
+      case payload_llr8:
+         {
+         assertalways(h.kind == kind_ptable);
+         const int q = h.alphabet;
+         assert(n % q == 0);
+         for (size_t i = 0; i < n; i += q)
+            {
+            // quantize each entry relative to the largest in its element
+            double pmax = 0;
+            for (int d = 0; d < q; d++)
+               pmax = std::max(pmax, src[i + d]);
+            for (int d = 0; d < q; d++)
+               {
+               const double p = src[i + d];
+               double c = 255;
+               if (p > 0 && pmax > 0)
+                  c = std::min(c, floor(-log(p / pmax) / h.scale + 0.5));
+               dst[i + d] = char(libbase::int8u(c));
+               }
+            }
+         }
+         break;
+      default:
+         failwith("Unknown payload type in binary frame");
+      }
+   }
+
+// *** binaryframe_reader ***
+
+// Internal functions
+
+/*! \brief Get the next 'n' bytes of input
+ * Returns a pointer into the mapped file, or into an internal buffer when
+ * reading from a stream; this remains valid until the next call. At the end
+ * of input, returns NULL if 'allow_eof' is set, and fails otherwise.
+ */
+const char* binaryframe_reader::get_bytes(const size_t n, const bool allow_eof)
+   {
+   if (m_map)
+      {
+      if (m_pos == m_length && allow_eof)
+         return NULL;
+      assertalways(m_length - m_pos >= n);
+      const char* p = m_map + m_pos;
+      m_pos += n;
+      return p;
+      }
+   m_buf.resize(std::max(n, size_t(1)));
+   m_in->read(&m_buf[0], n);
+   if (m_in->gcount() == 0 && allow_eof)
+      return NULL;
+   assertalways(size_t(m_in->gcount()) == n);
+   return &m_buf[0];
+   }
+
+/*! \brief Read the next frame header
+ * \return False if there are no more frames
+ */
+bool binaryframe_reader::next_header()
+   {
+   const char* p = get_bytes(sizeof(binaryframe::header), true);
+   if (p == NULL)
+      return false;
+   std::memcpy(&m_header, p, sizeof(binaryframe::header));
+   assertalways(m_header.magic == binaryframe::magic);
+   assertalways(m_header.dims == 1 || m_header.dims == 2);
+   assertalways(m_header.rows >= 0 && m_header.cols >= 0);
+   assertalways(m_header.dims == 2 || m_header.cols == 1);
+   assertalways(binaryframe::components(m_header) >= 0);
+   binaryframe::value_bytes(m_header.payload);
+   return true;
+   }
+
+//! Read and decode the payload for the given number of elements
+void binaryframe_reader::read_values(const size_t elements)
+   {
+   const size_t n = elements * binaryframe::components(m_header);
+   const char* p = get_bytes(n * binaryframe::value_bytes(m_header.payload),
+         false);
+   m_values.resize(n);
+   if (n > 0)
+      binaryframe::decode(m_header, p, &m_values[0], n);
+   }
+
+// Constructors / Destructors
+
+binaryframe_reader::binaryframe_reader(std::istream& sin) :
+   m_in(&sin), m_map(NULL), m_length(0), m_pos(0), m_left(0)
+   {
+   }
+
+/*!
+ * The file is memory-mapped where possible; otherwise it is read as a
+ * stream.
+ */
+binaryframe_reader::binaryframe_reader(const std::string& fname) :
+   m_in(NULL), m_map(NULL), m_length(0), m_pos(0), m_left(0)
+   {
+#ifndef _WIN32
+   const int fd = ::open(fname.c_str(), O_RDONLY);
+   assertalways(fd >= 0);
+   struct stat s;
+   assertalways(fstat(fd, &s) == 0);
+   m_length = s.st_size;
+   void* p = (m_length > 0) ? mmap(NULL, m_length, PROT_READ, MAP_SHARED, fd,
+         0) : MAP_FAILED;
+   ::close(fd);
+   if (p != MAP_FAILED)
+      {
+      m_map = static_cast<const char*> (p);
+      return;
+      }
+   m_length = 0;
+#endif
+   m_file.open(fname.c_str(), std::ios::in | std::ios::binary);
+   assertalways(m_file);
+   m_in = &m_file;
+   }
+
+binaryframe_reader::~binaryframe_reader()
+   {
+#ifndef _WIN32
+   if (m_map)
+      munmap(const_cast<char*> (m_map), m_length);
+#endif
+   }
+
+// Input status
+
+bool binaryframe_reader::eof()
+   {
+   if (m_left > 0)
+      return false;
+   if (m_map)
+      return m_pos == m_length;
+   return m_in->peek() == std::char_traits<char>::eof();
+   }
+
+// *** binaryframe_writer ***
+
+binaryframe_writer::binaryframe_writer(std::ostream& sout,
+      const binaryframe::payload_t payload, const double scale) :
+   m_out(sout), m_payload(payload), m_scale(scale)
+   {
+   assertalways(scale > 0);
+   }
+
+//! Complete the header, then encode and write the frame
+void binaryframe_writer::write_frame(binaryframe::header& h)
+   {
+   h.magic = binaryframe::magic;
+   h.scale = float(m_scale);
+   if (h.payload == binaryframe::payload_llr8)
+      assertalways(h.kind == binaryframe::kind_ptable);
+   const size_t n = m_values.size();
+   m_buf.resize(std::max(binaryframe::payload_bytes(h), size_t(1)));
+   if (n > 0)
+      binaryframe::encode(h, &m_values[0], &m_buf[0], n);
+   m_out.write(reinterpret_cast<const char*> (&h), sizeof(h));
+   m_out.write(&m_buf[0], binaryframe::payload_bytes(h));
+   assertalways(m_out);
+   }
+
+} // end namespace
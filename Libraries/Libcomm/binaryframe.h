@@ -0,0 +1,511 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __binaryframe_h
+#define __binaryframe_h
+
+#include "config.h"
+#include "vector.h"
+#include "matrix.h"
+#include "erasable.h"
+#include "sigspace.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace libcomm {
+
+/*!
+ * \brief   Binary Frame Format.
+ * \author  Johann Briffa
+ *
+ * Framed binary representation of the blocks exchanged by the CSencode,
+ * CStransmit and CSdecode tools, as an alternative to whitespace-separated
+ * text. Each frame consists of a fixed-size header followed by its payload:
+ * - magic number "SCF1"
+ * - frame kind: a block of symbols, or a table of symbol probabilities
+ * - symbol representation: integer (with -1 for erasures), or signal space
+ * - alphabet size (the number of entries per element for probability
+ * tables; zero if not known)
+ * - payload type: 32-bit integer, 32-bit or 64-bit float, or 8-bit
+ * quantized log-likelihood
+ * - container dimensions (1 for vector, 2 for matrix), rows and columns
+ * - quantization step, for 8-bit payloads
+ *
+ * All fields and payload values use the native byte order; the header is
+ * made up of 32-bit fields throughout.
+ *
+ * Quantized probability tables store, for each entry, the negative log of
+ * its ratio to the largest entry in the same element, in units of the
+ * quantization step and saturated at 255; on reading, entries are restored
+ * relative to a largest entry of one.
+ */
+
+class binaryframe {
+public:
+   /*! \name Type definitions */
+   //! Frame kind
+   enum kind_t {
+      kind_symbols = 0, //!< Block of symbols
+      kind_ptable //!< Table of symbol probabilities
+   };
+   //! Symbol representation
+   enum symbol_t {
+      symbol_integer = 0, //!< Integer value, -1 for erasures
+      symbol_sigspace, //!< Signal-space point (in-phase, quadrature)
+      symbol_probability //!< Probability table entry
+   };
+   //! Payload type
+   enum payload_t {
+      payload_int32 = 0, //!< 32-bit integer
+      payload_float32, //!< 32-bit floating-point
+      payload_float64, //!< 64-bit floating-point
+      payload_llr8 //!< 8-bit quantized log-likelihood
+   };
+   //! Frame header
+   struct header {
+      libbase::int32s magic; //!< Magic number, "SCF1"
+      libbase::int32s kind; //!< Frame kind
+      libbase::int32s symbol; //!< Symbol representation
+      libbase::int32s alphabet; //!< Alphabet size (zero if not known)
+      libbase::int32s payload; //!< Payload type
+      libbase::int32s dims; //!< Number of container dimensions
+      libbase::int32s rows; //!< Number of rows (or vector length)
+      libbase::int32s cols; //!< Number of columns (one for vectors)
+      float scale; //!< Quantization step, for 8-bit payloads
+   };
+   // @}
+
+   /*! \name Format details */
+   //! Magic number
+   static const libbase::int32s magic;
+   //! Number of payload values for each element
+   static int components(const header& h);
+   //! Size of each payload value in bytes
+   static int value_bytes(const int payload);
+   //! Total size of a frame's payload in bytes
+   static size_t payload_bytes(const header& h)
+      {
+      return size_t(h.rows) * h.cols * components(h) * value_bytes(h.payload);
+      }
+   //! Convert payload type from its name (int32, float, double, llr8)
+   static payload_t payload_from_name(const std::string& name);
+   //! Convert 'n' payload values to double
+   static void decode(const header& h, const char* src, double* dst,
+         const size_t n);
+   //! Convert 'n' values from double to payload
+   static void encode(const header& h, const double* src, char* dst,
+         const size_t n);
+   // @}
+};
+
+/*!
+ * \brief   Binary Frame Symbol Conversion.
+ * \author  Johann Briffa
+ *
+ * Maps a symbol type to its representation in binary frames. The general
+ * case handles symbols that convert to and from integers, such as bool and
+ * the finite field types.
+ */
+
+template <class S>
+class binaryframe_symbol {
+public:
+   static const int type = binaryframe::symbol_integer;
+   static const int components = 1;
+   static int alphabet()
+      {
+      return S::elements();
+      }
+   static void put(const S& x, double* c)
+      {
+      c[0] = int(x);
+      }
+   static S get(const double* c)
+      {
+      return S(int(c[0]));
+      }
+};
+
+template <>
+class binaryframe_symbol<int> {
+public:
+   static const int type = binaryframe::symbol_integer;
+   static const int components = 1;
+   static int alphabet()
+      {
+      return 0;
+      }
+   static void put(const int& x, double* c)
+      {
+      c[0] = x;
+      }
+   static int get(const double* c)
+      {
+      return int(c[0]);
+      }
+};
+
+template <>
+class binaryframe_symbol<bool> {
+public:
+   static const int type = binaryframe::symbol_integer;
+   static const int components = 1;
+   static int alphabet()
+      {
+      return 2;
+      }
+   static void put(const bool& x, double* c)
+      {
+      c[0] = x ? 1 : 0;
+      }
+   static bool get(const double* c)
+      {
+      return c[0] != 0;
+      }
+};
+
+template <class S>
+class binaryframe_symbol<libbase::erasable<S> > {
+public:
+   static const int type = binaryframe::symbol_integer;
+   static const int components = 1;
+   static int alphabet()
+      {
+      return binaryframe_symbol<S>::alphabet();
+      }
+   static void put(const libbase::erasable<S>& x, double* c)
+      {
+      c[0] = x.is_erased() ? -1 : int(x);
+      }
+   static libbase::erasable<S> get(const double* c)
+      {
+      libbase::erasable<S> x(c[0] < 0 ? 0 : int(c[0]));
+      if (c[0] < 0)
+         x.erase();
+      return x;
+      }
+};
+
+template <>
+class binaryframe_symbol<sigspace> {
+public:
+   static const int type = binaryframe::symbol_sigspace;
+   static const int components = 2;
+   static int alphabet()
+      {
+      return 0;
+      }
+   static void put(const sigspace& x, double* c)
+      {
+      c[0] = x.i();
+      c[1] = x.q();
+      }
+   static sigspace get(const double* c)
+      {
+      return sigspace(c[0], c[1]);
+      }
+};
+
+/*!
+ * \brief   Binary Frame Reader.
+ * \author  Johann Briffa
+ *
+ * Reads frames in the binary frame format, either from a stream (so that
+ * input may come through a pipe) or from a named file, which is
+ * memory-mapped where supported so that payloads are converted directly
+ * from the mapping.
+ *
+ * Besides whole frames, symbols may also be read as a continuous sequence
+ * that runs across frame boundaries, as needed for stream-oriented systems.
+ */
+
+class binaryframe_reader {
+private:
+   /*! \name Input source */
+   std::istream* m_in; //!< Input stream, if reading from a stream
+   std::ifstream m_file; //!< Input file, if not mapped
+   const char* m_map; //!< Mapped file contents, if mapped
+   size_t m_length; //!< Length of mapped file
+   size_t m_pos; //!< Read position within mapped file
+   std::vector<char> m_buf; //!< Buffer for data read from a stream
+   // @}
+   /*! \name Current frame */
+   binaryframe::header m_header; //!< Header of current frame
+   int m_left; //!< Elements not yet read from current frame (symbol reads)
+   std::vector<double> m_values; //!< Decoded values of current read
+   // @}
+private:
+   /*! \name Internal functions */
+   const char* get_bytes(const size_t n, const bool allow_eof);
+   bool next_header();
+   void read_values(const size_t elements);
+   // @}
+   // Not copyable
+   binaryframe_reader(const binaryframe_reader&);
+   binaryframe_reader& operator=(const binaryframe_reader&);
+public:
+   /*! \name Constructors / Destructors */
+   explicit binaryframe_reader(std::istream& sin);
+   explicit binaryframe_reader(const std::string& fname);
+   ~binaryframe_reader();
+   // @}
+
+   //! Whether the input has no more frames
+   bool eof();
+
+   /*! \brief Read the next frame as a block of symbols
+    * \return False if there are no more frames
+    */
+   template <class S, template <class > class C>
+   bool read(C<S>& frame);
+   /*! \brief Read the next frame as a table of symbol probabilities
+    * \return False if there are no more frames
+    */
+   template <template <class > class C>
+   bool read(C<libbase::vector<double> >& ptable);
+   /*! \brief Read up to 'n' symbols, continuing across frames
+    * \return The number of symbols read, which is less than 'n' only at the
+    * end of the input
+    */
+   template <class S>
+   int read_symbols(libbase::vector<S>& result, const int n);
+};
+
+/*!
+ * \brief   Binary Frame Writer.
+ * \author  Johann Briffa
+ *
+ * Writes frames in the binary frame format to a stream. Integer symbols are
+ * always written as 32-bit integers; signal-space points and probability
+ * tables use the payload type given at construction.
+ */
+
+class binaryframe_writer {
+private:
+   std::ostream& m_out; //!< Output stream
+   binaryframe::payload_t m_payload; //!< Payload type for real values
+   double m_scale; //!< Quantization step, for 8-bit payloads
+   std::vector<double> m_values; //!< Values to be written
+   std::vector<char> m_buf; //!< Encoded payload
+private:
+   void write_frame(binaryframe::header& h);
+public:
+   /*! \name Constructors / Destructors */
+   explicit binaryframe_writer(std::ostream& sout,
+         const binaryframe::payload_t payload = binaryframe::payload_float64,
+         const double scale = 0.125);
+   // @}
+
+   //! Write a block of symbols as a frame
+   template <class S, template <class > class C>
+   void write(const C<S>& frame);
+   //! Write a table of symbol probabilities as a frame
+   template <template <class > class C>
+   void write(const C<libbase::vector<double> >& ptable);
+};
+
+// Container helpers
+
+namespace binaryframe_container {
+
+template <class T>
+void shape(const libbase::vector<T>& x, int& dims, int& rows, int& cols)
+   {
+   dims = 1;
+   rows = x.size();
+   cols = 1;
+   }
+
+template <class T>
+void shape(const libbase::matrix<T>& x, int& dims, int& rows, int& cols)
+   {
+   dims = 2;
+   rows = x.size().rows();
+   cols = x.size().cols();
+   }
+
+template <class T>
+void init(libbase::vector<T>& x, const int dims, const int rows,
+      const int cols)
+   {
+   assertalways(dims == 1);
+   x.init(rows);
+   }
+
+template <class T>
+void init(libbase::matrix<T>& x, const int dims, const int rows,
+      const int cols)
+   {
+   assertalways(dims == 2);
+   x.init(rows, cols);
+   }
+
+template <class T>
+T& element(libbase::vector<T>& x, const int i)
+   {
+   return x(i);
+   }
+
+template <class T>
+const T& element(const libbase::vector<T>& x, const int i)
+   {
+   return x(i);
+   }
+
+template <class T>
+T& element(libbase::matrix<T>& x, const int i)
+   {
+   const int cols = x.size().cols();
+   return x(i / cols, i % cols);
+   }
+
+template <class T>
+const T& element(const libbase::matrix<T>& x, const int i)
+   {
+   const int cols = x.size().cols();
+   return x(i / cols, i % cols);
+   }
+
+} // end namespace
+
+// Reader templates
+
+template <class S, template <class > class C>
+bool binaryframe_reader::read(C<S>& frame)
+   {
+   typedef binaryframe_symbol<S> traits;
+   assertalways(m_left == 0);
+   if (!next_header())
+      return false;
+   assertalways(m_header.kind == binaryframe::kind_symbols);
+   assertalways(m_header.symbol == traits::type);
+   binaryframe_container::init(frame, m_header.dims, m_header.rows,
+         m_header.cols);
+   const int n = m_header.rows * m_header.cols;
+   read_values(n);
+   m_left = 0;
+   for (int i = 0; i < n; i++)
+      binaryframe_container::element(frame, i) = traits::get(&m_values[i
+            * traits::components]);
+   return true;
+   }
+
+template <template <class > class C>
+bool binaryframe_reader::read(C<libbase::vector<double> >& ptable)
+   {
+   assertalways(m_left == 0);
+   if (!next_header())
+      return false;
+   assertalways(m_header.kind == binaryframe::kind_ptable);
+   binaryframe_container::init(ptable, m_header.dims, m_header.rows,
+         m_header.cols);
+   const int n = m_header.rows * m_header.cols;
+   const int q = m_header.alphabet;
+   read_values(n);
+   m_left = 0;
+   for (int i = 0; i < n; i++)
+      {
+      libbase::vector<double>& p = binaryframe_container::element(ptable, i);
+      p.init(q);
+      for (int d = 0; d < q; d++)
+         p(d) = m_values[i * q + d];
+      }
+   return true;
+   }
+
+template <class S>
+int binaryframe_reader::read_symbols(libbase::vector<S>& result, const int n)
+   {
+   typedef binaryframe_symbol<S> traits;
+   std::vector<S> items;
+   while (int(items.size()) < n)
+      {
+      if (m_left == 0)
+         {
+         if (!next_header())
+            break;
+         assertalways(m_header.kind == binaryframe::kind_symbols);
+         assertalways(m_header.symbol == traits::type);
+         m_left = m_header.rows * m_header.cols;
+         continue;
+         }
+      const int k = std::min(m_left, n - int(items.size()));
+      read_values(k);
+      m_left -= k;
+      for (int i = 0; i < k; i++)
+         items.push_back(traits::get(&m_values[i * traits::components]));
+      }
+   result.init(items.size());
+   for (int i = 0; i < result.size(); i++)
+      result(i) = items[i];
+   return result.size();
+   }
+
+// Writer templates
+
+template <class S, template <class > class C>
+void binaryframe_writer::write(const C<S>& frame)
+   {
+   typedef binaryframe_symbol<S> traits;
+   binaryframe::header h;
+   h.kind = binaryframe::kind_symbols;
+   h.symbol = traits::type;
+   h.alphabet = traits::alphabet();
+   h.payload = (traits::type == binaryframe::symbol_integer)
+         ? binaryframe::payload_int32 : m_payload;
+   binaryframe_container::shape(frame, h.dims, h.rows, h.cols);
+   const int n = h.rows * h.cols;
+   m_values.resize(n * traits::components);
+   for (int i = 0; i < n; i++)
+      traits::put(binaryframe_container::element(frame, i), &m_values[i
+            * traits::components]);
+   write_frame(h);
+   }
+
+template <template <class > class C>
+void binaryframe_writer::write(const C<libbase::vector<double> >& ptable)
+   {
+   binaryframe::header h;
+   h.kind = binaryframe::kind_ptable;
+   h.symbol = binaryframe::symbol_probability;
+   h.payload = m_payload;
+   binaryframe_container::shape(ptable, h.dims, h.rows, h.cols);
+   const int n = h.rows * h.cols;
+   h.alphabet = (n > 0) ? binaryframe_container::element(ptable, 0).size() : 0;
+   m_values.resize(n * h.alphabet);
+   for (int i = 0; i < n; i++)
+      {
+      const libbase::vector<double>& p = binaryframe_container::element(
+            ptable, i);
+      assertalways(p.size() == h.alphabet);
+      for (int d = 0; d < h.alphabet; d++)
+         m_values[i * h.alphabet + d] = p(d);
+      }
+   write_frame(h);
+   }
+
+} // end namespace
+
+#endif
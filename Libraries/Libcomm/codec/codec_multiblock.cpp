@@ -45,34 +45,54 @@ void codec_multiblock<C, dbl>::do_encode(const C<int>& source, C<int>& encoded)
    test_invariant();
    }
 
+/*!
+ * \brief Decode block 'i' using the given codec object
+ * If 'ro' is NULL, only the input-referred posteriors are computed.
+ */
 template <template <class > class C, class dbl>
-void codec_multiblock<C, dbl>::softdecode(C<array1d_t>& ri)
+void codec_multiblock<C, dbl>::softdecode_block(codec_softout<C, dbl>& thiscdc,
+      const int i, C<array1d_t>& ri, C<array1d_t>* ro)
    {
-   test_invariant();
-   // allocate output vector
-   libbase::allocate(ri, this->input_block_size(), this->num_inputs());
-   // iterate over all blocks in sequence
-   for (int i = 0; i < N; i++)
+   // Initialize the codec
+   libbase::indirect_vector<array1d_t> ptable_segment = ptable.extract(
+         cdc->output_block_size() * i, cdc->output_block_size());
+   if (app.size() > 0)
       {
-      // Initialize the codec
-      libbase::indirect_vector<array1d_t> ptable_segment = ptable.extract(
-            cdc->output_block_size() * i, cdc->output_block_size());
-      if (app.size() > 0)
+      libbase::indirect_vector<array1d_t> app_segment = app.extract(
+            cdc->input_block_size() * i, cdc->input_block_size());
+      thiscdc.init_decoder(ptable_segment, app_segment);
+      }
+   else
+      thiscdc.init_decoder(ptable_segment);
+   // Perform soft-output decoding for as many iterations as needed
+   for (int j = 0; j < thiscdc.num_iter(); j++)
+      {
+      libbase::indirect_vector<array1d_t> ri_segment = ri.segment(
+            cdc->input_block_size() * i, cdc->input_block_size());
+      if (ro)
          {
-         libbase::indirect_vector<array1d_t> app_segment = app.extract(
-               cdc->input_block_size() * i, cdc->input_block_size());
-         cdc->init_decoder(ptable_segment, app_segment);
+         libbase::indirect_vector<array1d_t> ro_segment = ro->segment(
+               cdc->output_block_size() * i, cdc->output_block_size());
+         thiscdc.softdecode(ri_segment, ro_segment);
          }
       else
-         cdc->init_decoder(ptable_segment);
-      // Perform soft-output decoding for as many iterations as needed
-      for (int j = 0; j < cdc->num_iter(); j++)
-         {
-         libbase::indirect_vector<array1d_t> ri_segment = ri.segment(
-               cdc->input_block_size() * i, cdc->input_block_size());
-         cdc->softdecode(ri_segment);
-         }
+         thiscdc.softdecode(ri_segment);
       }
+   }
+
+template <template <class > class C, class dbl>
+void codec_multiblock<C, dbl>::softdecode(C<array1d_t>& ri)
+   {
+   test_invariant();
+   // make sure we have decoder copies (if we were not seeded)
+   if (cdc_dec.empty())
+      init_decoders();
+   // allocate output vector
+   libbase::allocate(ri, this->input_block_size(), this->num_inputs());
+   // decode all blocks, in parallel where possible
+#pragma omp parallel for schedule(dynamic)
+   for (int i = 0; i < N; i++)
+      softdecode_block(*cdc_dec[libbase::getthreadid()], i, ri, NULL);
    test_invariant();
    }
 
@@ -80,33 +100,16 @@ template <template <class > class C, class dbl>
 void codec_multiblock<C, dbl>::softdecode(C<array1d_t>& ri, C<array1d_t>& ro)
    {
    test_invariant();
+   // make sure we have decoder copies (if we were not seeded)
+   if (cdc_dec.empty())
+      init_decoders();
    // allocate output vectors
    libbase::allocate(ri, this->input_block_size(), this->num_inputs());
    libbase::allocate(ro, this->output_block_size(), this->num_outputs());
-   // iterate over all blocks in sequence
+   // decode all blocks, in parallel where possible
+#pragma omp parallel for schedule(dynamic)
    for (int i = 0; i < N; i++)
-      {
-      // Initialize the codec
-      libbase::indirect_vector<array1d_t> ptable_segment = ptable.extract(
-            cdc->output_block_size() * i, cdc->output_block_size());
-      if (app.size() > 0)
-         {
-         libbase::indirect_vector<array1d_t> app_segment = app.extract(
-               cdc->input_block_size() * i, cdc->input_block_size());
-         cdc->init_decoder(ptable_segment, app_segment);
-         }
-      else
-         cdc->init_decoder(ptable_segment);
-      // Perform soft-output decoding for as many iterations as needed
-      for (int j = 0; j < cdc->num_iter(); j++)
-         {
-         libbase::indirect_vector<array1d_t> ri_segment = ri.segment(
-               cdc->input_block_size() * i, cdc->input_block_size());
-         libbase::indirect_vector<array1d_t> ro_segment = ro.segment(
-               cdc->output_block_size() * i, cdc->output_block_size());
-         cdc->softdecode(ri_segment, ro_segment);
-         }
-      }
+      softdecode_block(*cdc_dec[libbase::getthreadid()], i, ri, &ro);
    test_invariant();
    }
 
@@ -155,6 +158,8 @@ std::istream& codec_multiblock<C, dbl>::serialize(std::istream& sin)
    // get access to soft-out object (and confirm this is valid)
    cdc = boost::dynamic_pointer_cast<codec_softout<C, dbl> >(this_codec);
    assertalways(cdc);
+   // discard any decoder copies of a previous codec
+   cdc_dec.clear();
    // get number of blocks to aggregate
    sin >> libbase::eatcomments >> N >> libbase::verify;
    test_invariant();
@@ -26,6 +26,7 @@
 #include "codec_softout.h"
 
 #include "boost/shared_ptr.hpp"
+#include <vector>
 
 namespace libcomm {
 
@@ -41,6 +42,9 @@ namespace libcomm {
 /*!
  * \brief   Channel Codec aggregating multiple blocks of underlying codec.
  * \author  Johann Briffa
+ *
+ * Blocks are independent, so decoding is split across threads (when built
+ * with OpenMP); each thread uses its own copy of the underlying codec.
  */
 
 template <template <class > class C = libbase::vector, class dbl = double>
@@ -56,6 +60,7 @@ private:
    // @}
    /*! \name Internally-used objects */
    boost::shared_ptr<codec_softout<C, dbl> > cdc_enc; //!< Copy of codec object for encoder operations
+   std::vector<boost::shared_ptr<codec_softout<C, dbl> > > cdc_dec; //!< Copies of codec object for decoder operations, one per thread
    C<array1d_t> ptable; //!< Copy of channel probabilities, to be segmented and used
    C<array1d_t> app; //!< Copy of prior probabilities, to be segmented and used
    // @}
@@ -68,6 +73,17 @@ protected:
       assert(cdc);
       assert(N >= 1);
       }
+   //! Make per-thread copies of codec object for decoder operations
+   void init_decoders()
+      {
+      cdc_dec.resize(libbase::getthreadcount());
+      for (size_t t = 0; t < cdc_dec.size(); t++)
+         cdc_dec[t] = boost::dynamic_pointer_cast<codec_softout<C, dbl> >(
+               cdc->clone());
+      }
+   //! Decode a single block, using the given codec object
+   void softdecode_block(codec_softout<C, dbl>& thiscdc, const int i,
+         C<array1d_t>& ri, C<array1d_t>* ro);
    // @}
    // Interface with derived classes
    void do_encode(const C<int>& source, C<int>& encoded);
@@ -92,6 +108,8 @@ public:
       cdc->seedfrom(r);
       // Make a copy of codec object for encoder operations
       cdc_enc = boost::dynamic_pointer_cast<codec_softout<C, dbl> >(cdc->clone());
+      // Make copies of codec object for decoder operations
+      init_decoders();
       }
    void softdecode(C<array1d_t>& ri);
    void softdecode(C<array1d_t>& ri, C<array1d_t>& ro);
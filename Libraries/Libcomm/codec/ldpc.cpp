@@ -27,6 +27,7 @@
  */
 
 #include "ldpc.h"
+#include "tablecache.h"
 #include "linear_code_utils.h"
 #include "randgen.h"
 #include "sumprodalg/spa_factory.h"
@@ -44,6 +45,32 @@ namespace libcomm {
 #  define DEBUG 1
 #endif
 
+template <class GF_q, class real> ldpc<GF_q, real>::ldpc(
+      const ldpc<GF_q, real>& x) :
+   codec_softout<libbase::vector, double> (x), max_iter(x.max_iter),
+         current_iteration(x.current_iteration), length_n(x.length_n),
+         dim_pchk(x.dim_pchk), dim_k(x.dim_k),
+         max_row_weight(x.max_row_weight), max_col_weight(x.max_col_weight),
+         row_weight(x.row_weight), col_weight(x.col_weight),
+         rand_prov_values(x.rand_prov_values), seed(x.seed), N_m(x.N_m),
+         M_n(x.M_n), pchk_matrix(x.pchk_matrix), gen_matrix(x.gen_matrix),
+         encoder(x.encoder), perm_to_systematic(x.perm_to_systematic),
+         info_symb_pos(x.info_symb_pos), received_probs(x.received_probs),
+         computed_solution(x.computed_solution),
+         decodingSuccess(x.decodingSuccess), reduce_to_ref(x.reduce_to_ref),
+         received_word_hd(x.received_word_hd), hd_functor(x.hd_functor)
+   {
+   // create a separate SPA object with the same settings
+   if (x.spa_alg)
+      {
+      this->spa_alg = libcomm::spa_factory<GF_q, real>::get_spa(
+            x.spa_alg->spa_type(), this->length_n, this->dim_pchk, this->M_n,
+            this->N_m, this->pchk_matrix);
+      this->spa_alg->set_clipping(x.spa_alg->get_clipping_type(),
+            x.spa_alg->get_almostzero());
+      }
+   }
+
 template <class GF_q, class real> ldpc<GF_q, real>::ldpc(
       libbase::matrix<GF_q> paritycheck_mat, const int num_of_iters)
    {
@@ -147,6 +174,17 @@ template <class GF_q, class real> ldpc<GF_q, real>::ldpc(
 
 template <class GF_q, class real> void ldpc<GF_q, real>::init()
    {
+   if (this->reduce_to_ref == false)
+      {
+      //set up the sparse encoder, which determines the positions of the
+      //info symbols itself; this avoids computing a dense generator matrix
+      this->encoder.init(this->pchk_matrix, this->N_m, this->M_n);
+      this->dim_k = this->encoder.dimension();
+      this->info_symb_pos = this->encoder.get_info_positions();
+      this->gen_matrix.init(0, 0);
+      this->perm_to_systematic.init(0);
+      return;
+      }
 
    //compute the generator matrix for the code
 
@@ -156,35 +194,19 @@ template <class GF_q, class real> void ldpc<GF_q, real>::init()
    this->dim_k = this->gen_matrix.size().rows();
    this->info_symb_pos.init(this->dim_k);
 
-   if (this->reduce_to_ref == false)
-      {
-      //as we define the LDPC code by its parity check matrix,H , the generator matrix
-      //will be of the form (P|I) provided H was in systematic form when reduced to REF
-      //if H wasn't then perm_to_systematic contains the permutation that transformed
-      //H into systematic form which gives us the information we need to extract the
-      //positions of the info symbols in G. In fact the last k values of perm_to_systematic
-      //are those positions.
-      for (int loop = 0; loop < this->dim_k; loop++)
-         {
-         this ->info_symb_pos(loop) = this->perm_to_systematic((this->length_n
-               - this->dim_k) + loop);
-         }
-      }
-   else
+   //we reduce the generator matrix to REF format in the hope that the info symbols will be
+   //in the first k positions and that we'll therefore have a systematic code
+   this->gen_matrix = libbase::linear_code_utils<GF_q>::compute_ref(
+         this->gen_matrix);
+   //we now need to find the pivots
+   int posy = 0;
+   for (int loop = 0; loop < this->dim_k; loop++)
       {
-      //we reduce the generator matrix to REF format in the hope that the info symbols will be
-      //in the first k positions and that we'll therefore have a systematic code
-      this->gen_matrix = this->gen_matrix.reduce_to_ref();
-      //we now need to find the pivots
-      int posy = 0;
-      for (int loop = 0; loop < this->dim_k; loop++)
+      while (this->gen_matrix(loop, posy) == GF_q(0))
          {
-         while (this->gen_matrix(loop, posy) == GF_q(0))
-            {
-            posy++;
-            }
-         this->info_symb_pos(loop) = posy;
+         posy++;
          }
+      this->info_symb_pos(loop) = posy;
       }
    }
 
@@ -286,8 +308,11 @@ template <class GF_q, class real> void ldpc<GF_q, real>::isCodeword()
 template <class GF_q, class real> void ldpc<GF_q, real>::do_encode(
       const libbase::vector<int>& source, libbase::vector<int>& encoded)
    {
-   libbase::linear_code_utils<GF_q>::encode_cw(this->gen_matrix, source,
-         encoded);
+   if (this->reduce_to_ref)
+      libbase::linear_code_utils<GF_q>::encode_cw(this->gen_matrix, source,
+            encoded);
+   else
+      this->encoder.encode(source, encoded);
 
 #if DEBUG>=2
    this->received_word_hd = encoded;
@@ -585,25 +610,36 @@ template <class GF_q, class real> std::istream& ldpc<GF_q, real>::serialize(
       assertalways(this->seed>=0);
       rng.seed(this->seed);
       }
+   // the weights and positions may be large, so are read through the cache
+
    //read the col weights and ensure they are sensible
-   this->col_weight.init(this->length_n);
-   sin >> libbase::eatcomments >> this->col_weight >> libbase::verify;
+   libbase::tablecache::read(sin, this->col_weight);
+   assertalways(this->col_weight.size()==this->length_n);
    assertalways((1<=this->col_weight.min())&&(this->col_weight.max()<=this->max_col_weight));
 
    //read the row weights and ensure they are sensible
-   this->row_weight.init(this->dim_pchk);
-   sin >> libbase::eatcomments >> this->row_weight >> libbase::verify;
+   libbase::tablecache::read(sin, this->row_weight);
+   assertalways(this->row_weight.size()==this->dim_pchk);
    assertalways((0<this->row_weight.min())&&(this->row_weight.max()<=this->max_row_weight));
 
-   this->M_n.init(this->length_n);
-
-   //read the non-zero entries pos per col
+   //read the non-zero entries pos per col, each preceded by their number
+   int count = 0;
    for (int loop1 = 0; loop1 < this->length_n; loop1++)
+      count += 1 + this->col_weight(loop1);
+   std::vector<int> table;
+   libbase::tablecache::read(sin, count, table);
+   libbase::verify(sin);
+   this->M_n.init(this->length_n);
+   for (int loop1 = 0, k = 0; loop1 < this->length_n; loop1++)
       {
-      this->M_n(loop1).init(this->col_weight(loop1));
-      sin >> libbase::eatcomments >> this ->M_n(loop1) >> libbase::verify;
       //ensure that the number of non-zero pos matches the previously read value
-      assertalways(this->M_n(loop1).size()==this->col_weight(loop1));
+      assertalways(table[k++]==this->col_weight(loop1));
+      this->M_n(loop1).init(this->col_weight(loop1));
+      for (int loop2 = 0; loop2 < this->col_weight(loop1); loop2++)
+         {
+         this->M_n(loop1)(loop2) = table[k++];
+         assertalways((1<=this->M_n(loop1)(loop2))&&(this->M_n(loop1)(loop2)<=this->dim_pchk));
+         }
       }
 
    //init the parity check matrix and read in the non-zero entries
@@ -611,7 +647,23 @@ template <class GF_q, class real> std::istream& ldpc<GF_q, real>::serialize(
    this->pchk_matrix = GF_q(0);
    libbase::vector<GF_q> non_zero_vals;
    const int num_of_non_zero_elements = GF_q::elements() - 1;
-   for (int loop1 = 0; loop1 < this->length_n; loop1++)
+   // provided values are read through the cache, each column preceded by
+   // the number of values
+   bool cached = false;
+   table.clear();
+   if ("provided" == this->rand_prov_values)
+      {
+      cached = libbase::tablecache::lookup(count, table);
+      if (cached)
+         for (int loop1 = 0; loop1 < this->length_n; loop1++)
+            {
+            libbase::tablecache::skip(sin, 1);
+            libbase::tablecache::skip(sin, this->col_weight(loop1),
+                  GF_q::dimension());
+            }
+      libbase::verify(sin);
+      }
+   for (int loop1 = 0, k = 0; loop1 < this->length_n; loop1++)
       {
       const int tmp_entries = this->M_n(loop1).size();
       non_zero_vals.init(tmp_entries);
@@ -629,10 +681,21 @@ template <class GF_q, class real> std::istream& ldpc<GF_q, real>::serialize(
             }
          assertalways(non_zero_vals.min()!=GF_q(0));
          }
+      else if (cached)
+         {
+         assertalways(table[k++]==tmp_entries);
+         for (int loop_e = 0; loop_e < tmp_entries; loop_e++)
+            non_zero_vals(loop_e) = GF_q(table[k++]);
+         assertalways(non_zero_vals.min()!=GF_q(0));
+         }
       else
          {
          sin >> libbase::eatcomments >> non_zero_vals >> libbase::verify;
+         assertalways(non_zero_vals.size()==tmp_entries);
          assertalways(non_zero_vals.min()!=GF_q(0));
+         table.push_back(tmp_entries);
+         for (int loop_e = 0; loop_e < tmp_entries; loop_e++)
+            table.push_back(non_zero_vals(loop_e));
          }
       for (int loop2 = 0; loop2 < tmp_entries; loop2++)
          {
@@ -640,25 +703,31 @@ template <class GF_q, class real> std::istream& ldpc<GF_q, real>::serialize(
          this->pchk_matrix(tmp_pos, loop1) = non_zero_vals(loop2);
          }
       }
+   if ("provided" == this->rand_prov_values && !cached)
+      libbase::tablecache::store(table);
 
-   //derive the non-zero position per row from the parity check matrix
+   //derive the non-zero position per row from those per col; taking the
+   //cols in order keeps the positions in each row in increasing order
    this->N_m.init(this->dim_pchk);
+   libbase::vector<int> row_fill(this->dim_pchk);
+   row_fill = 0;
    for (int loop1 = 0; loop1 < this->dim_pchk; loop1++)
-      {
-      const int tmp_entries = this->row_weight(loop1);
-      this->N_m(loop1).init(tmp_entries);
-      int tmp_pos = 0;
-      for (int loop2 = 0; loop2 < this->length_n; loop2++)
+      this->N_m(loop1).init(this->row_weight(loop1));
+   for (int loop2 = 0; loop2 < this->length_n; loop2++)
+      for (int loop_e = 0; loop_e < this->M_n(loop2).size(); loop_e++)
          {
-         if (GF_q(0) != this->pchk_matrix(loop1, loop2))
-            {
-            assertalways(tmp_pos<tmp_entries);
-            this->N_m(loop1)(tmp_pos) = loop2 + 1;//we count from 0;
-            tmp_pos++;
-            }
+         const int tmp_pos = this->M_n(loop2)(loop_e) - 1;//we count from 0
+         //skip repeated positions, which only set the entry again
+         if (row_fill(tmp_pos) > 0 && this->N_m(tmp_pos)(row_fill(tmp_pos) - 1)
+               == loop2 + 1)
+            continue;
+         assertalways(row_fill(tmp_pos)<this->row_weight(tmp_pos));
+         this->N_m(tmp_pos)(row_fill(tmp_pos)++) = loop2 + 1;
          }
-      //tmp_pos should now correspond to the given row weight
-      assertalways(tmp_pos==this->row_weight(loop1));
+   for (int loop1 = 0; loop1 < this->dim_pchk; loop1++)
+      {
+      //the count should now correspond to the given row weight
+      assertalways(row_fill(loop1)==this->row_weight(loop1));
       }
    this->spa_alg = libcomm::spa_factory<GF_q, real>::get_spa(spa_type,
          this->length_n, this->dim_pchk, this->M_n, this->N_m,
@@ -35,6 +35,7 @@
 #include "matrix.h"
 #include "sumprodalg/sum_prod_alg_inf.h"
 #include "hard_decision.h"
+#include "ldpc_encoder.h"
 
 #include "boost/shared_ptr.hpp"
 
@@ -117,6 +118,11 @@ public:
     *
     */
    ldpc(libbase::matrix<GF_q> paritycheck_mat, const int num_of_iters);
+   /*! \brief copy constructor
+    * The SPA object holds the decoder state, so the copy is given its own
+    * instance; this allows copies to decode concurrently.
+    */
+   ldpc(const ldpc<GF_q, real>& x);
 
 
    /*! \name Codec operations */
@@ -287,8 +293,13 @@ private:
    libbase::matrix<GF_q> pchk_matrix;
 
    //!The generator matrix of the code in REF
+   //(only used if reduce_to_ref is set)
    libbase::matrix<GF_q> gen_matrix;
 
+   //!Encoder working directly on the parity check matrix
+   //(used unless reduce_to_ref is set)
+   ldpc_encoder<GF_q> encoder;
+
    //! the permutation that swaps the columns so that
    //the parity check matrix is in standard form, eg (I|P)
    array1i_t perm_to_systematic;
@@ -308,8 +319,9 @@ private:
 
    //! flag indicating whether the generator matrix should be reduced to
    //REF form in the hope of getting a proper systematic code.
-   //If set to false, initialisation is quicker and the info symbols are
-   //at the end of the codeword
+   //If set to false, no generator matrix is computed; encoding works
+   //directly on the sparse parity check matrix, and the info symbols are
+   //at positions determined by the encoder
    //If set to true, the info symbols will be at the beginning of the
    //code word.
    //Note that it is not guaranteed that they will be in the first
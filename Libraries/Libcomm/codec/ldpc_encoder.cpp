@@ -0,0 +1,323 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ldpc_encoder.h"
+#include <vector>
+#include <algorithm>
+
+namespace libcomm {
+
+// Determine debug level:
+// 1 - Normal debug output only
+// 2 - Show triangulation results
+#ifndef NDEBUG
+#  undef DEBUG
+#  define DEBUG 1
+#endif
+
+// Internal functions
+
+/*!
+ * \brief Determine all non-free symbols by back-substitution
+ * Each step solves a check for the one symbol it determines, given the
+ * free symbols and those determined in earlier steps.
+ */
+template <class GF_q>
+void ldpc_encoder<GF_q>::back_substitute(array1gfq_t& x) const
+   {
+   for (int t = 0; t < step_row.size(); t++)
+      {
+      const int i = step_row(t);
+      const int c = step_col(t);
+      GF_q s = 0;
+      GF_q h = 0;
+      for (int j = 0; j < row_pos(i).size(); j++)
+         {
+         const int pos = row_pos(i)(j);
+         if (pos == c)
+            h = row_val(i)(j);
+         else
+            s += row_val(i)(j) * x(pos);
+         }
+      x(c) = s / h;
+      }
+   }
+
+// Setup
+
+template <class GF_q>
+void ldpc_encoder<GF_q>::init(const libbase::matrix<GF_q>& H,
+      const array1vi_t& N_m, const array1vi_t& M_n)
+   {
+   n = H.size().cols();
+   const int m = H.size().rows();
+   assertalways(N_m.size() == m);
+   assertalways(M_n.size() == n);
+   // copy sparse representation of H, counting from zero
+   row_pos.init(m);
+   row_val.init(m);
+   int max_deg = 0;
+   for (int i = 0; i < m; i++)
+      {
+      const int w = N_m(i).size();
+      row_pos(i).init(w);
+      row_val(i).init(w);
+      for (int j = 0; j < w; j++)
+         {
+         row_pos(i)(j) = N_m(i)(j) - 1;
+         row_val(i)(j) = H(i, row_pos(i)(j));
+         }
+      max_deg = std::max(max_deg, w);
+      }
+
+   // ** greedy triangulation **
+
+   // symbol state: 0 = unknown, 1 = determined by a check, 2 = free
+   array1i_t state(n);
+   state = 0;
+   // number of unknown symbols in each unused check
+   array1i_t deg(m);
+   libbase::vector<bool> used(m);
+   used = false;
+   // checks indexed by degree; entries are stale if the degree has changed
+   std::vector<std::vector<int> > bucket(max_deg + 1);
+   for (int i = 0; i < m; i++)
+      {
+      deg(i) = row_pos(i).size();
+      bucket[deg(i)].push_back(i);
+      }
+   int cur = 1;
+   std::vector<int> steps_r, steps_c;
+   while (true)
+      {
+      // find an unused check of least non-zero degree
+      int i = -1;
+      while (cur <= max_deg && i < 0)
+         {
+         if (bucket[cur].empty())
+            {
+            cur++;
+            continue;
+            }
+         const int r = bucket[cur].back();
+         bucket[cur].pop_back();
+         if (!used(r) && deg(r) == cur)
+            i = r;
+         }
+      if (i < 0)
+         break;
+      // keep the unknown symbol involved in fewest checks; declare the others
+      // free, as they reduce the degree of more checks
+      int keep = -1;
+      for (int j = 0; j < row_pos(i).size(); j++)
+         {
+         const int c = row_pos(i)(j);
+         if (state(c) == 0 && (keep < 0 || M_n(c).size() < M_n(keep).size()))
+            keep = c;
+         }
+      for (int j = 0; j <= row_pos(i).size(); j++)
+         {
+         // the kept symbol is handled last
+         const int c = (j < row_pos(i).size()) ? row_pos(i)(j) : keep;
+         if (state(c) != 0 || (c == keep && j < row_pos(i).size()))
+            continue;
+         if (c == keep)
+            {
+            // use this check to determine the last unknown symbol
+            assert(deg(i) == 1);
+            state(c) = 1;
+            used(i) = true;
+            steps_r.push_back(i);
+            steps_c.push_back(c);
+            }
+         else
+            state(c) = 2;
+         // update degrees of other checks involving this symbol
+         for (int k = 0; k < M_n(c).size(); k++)
+            {
+            const int r = M_n(c)(k) - 1;
+            if (used(r))
+               continue;
+            deg(r)--;
+            if (deg(r) > 0)
+               {
+               bucket[deg(r)].push_back(r);
+               cur = std::min(cur, deg(r));
+               }
+            }
+         }
+      }
+   // any symbols not involved in unused checks are free
+   for (int c = 0; c < n; c++)
+      if (state(c) == 0)
+         state(c) = 2;
+   step_row.init(steps_r.size());
+   step_col.init(steps_c.size());
+   for (int t = 0; t < step_row.size(); t++)
+      {
+      step_row(t) = steps_r[t];
+      step_col(t) = steps_c[t];
+      }
+
+   // ** gap system **
+
+   // list free symbols and left-over checks
+   std::vector<int> free_sym, left;
+   for (int c = 0; c < n; c++)
+      if (state(c) == 2)
+         free_sym.push_back(c);
+   for (int i = 0; i < m; i++)
+      if (!used(i))
+         left.push_back(i);
+   const int nf = free_sym.size();
+   const int nl = left.size();
+   // express each left-over check in terms of the free symbols only, by
+   // substituting the determined symbols in reverse order
+   libbase::vector<array1gfq_t> phi(nl);
+   array1gfq_t w(n);
+   for (int l = 0; l < nl; l++)
+      {
+      const int i = left[l];
+      w = GF_q(0);
+      for (int j = 0; j < row_pos(i).size(); j++)
+         w(row_pos(i)(j)) = row_val(i)(j);
+      for (int t = step_row.size() - 1; t >= 0; t--)
+         {
+         const int c = step_col(t);
+         if (w(c) == GF_q(0))
+            continue;
+         const int r = step_row(t);
+         GF_q h = 0;
+         for (int j = 0; j < row_pos(r).size(); j++)
+            if (row_pos(r)(j) == c)
+               h = row_val(r)(j);
+         const GF_q f = w(c) / h;
+         for (int j = 0; j < row_pos(r).size(); j++)
+            w(row_pos(r)(j)) += f * row_val(r)(j);
+         assert(w(c) == GF_q(0));
+         }
+      phi(l).init(nf);
+      for (int k = 0; k < nf; k++)
+         phi(l)(k) = w(free_sym[k]);
+      }
+   // find an independent set of gap columns by forward elimination,
+   // keeping track of the original check for each row
+   libbase::vector<array1gfq_t> a = phi;
+   std::vector<int> a_row(nl);
+   for (int l = 0; l < nl; l++)
+      a_row[l] = l;
+   std::vector<int> piv_col, piv_row;
+   libbase::vector<bool> is_gap(nf);
+   is_gap = false;
+   for (int k = 0; k < nf && int(piv_row.size()) < nl; k++)
+      {
+      const int p = piv_row.size();
+      int r = p;
+      while (r < nl && a(r)(k) == GF_q(0))
+         r++;
+      if (r == nl)
+         continue;
+      std::swap(a(p), a(r));
+      std::swap(a_row[p], a_row[r]);
+      for (r = p + 1; r < nl; r++)
+         if (a(r)(k) != GF_q(0))
+            a(r) -= a(p) * (a(r)(k) / a(p)(k));
+      piv_col.push_back(k);
+      piv_row.push_back(a_row[p]);
+      is_gap(k) = true;
+      }
+   // set up gap system
+   const int g = piv_col.size();
+   gap_pos.init(g);
+   gap_row.init(g);
+   libbase::matrix<GF_q> phi_g(g, g);
+   for (int t = 0; t < g; t++)
+      {
+      gap_pos(t) = free_sym[piv_col[t]];
+      gap_row(t) = left[piv_row[t]];
+      for (int u = 0; u < g; u++)
+         phi_g(t, u) = phi(piv_row[t])(piv_col[u]);
+      }
+   gap_inv = (g > 0) ? phi_g.inverse() : phi_g;
+   // the remaining free symbols carry the information
+   info_pos.init(nf - g);
+   for (int k = 0, t = 0; k < nf; k++)
+      if (!is_gap(k))
+         info_pos(t++) = free_sym[k];
+#if DEBUG>=2
+   libbase::trace << "DEBUG (ldpc_encoder): n = " << n << ", k = "
+         << info_pos.size() << ", steps = " << step_row.size() << ", gap = "
+         << g << ", left-over checks = " << nl << std::endl;
+#endif
+   }
+
+// Encoding
+
+template <class GF_q>
+void ldpc_encoder<GF_q>::encode(const array1i_t& source, array1i_t& encoded) const
+   {
+   assertalways(source.size() == info_pos.size());
+   array1gfq_t x(n);
+   x = GF_q(0);
+   for (int i = 0; i < info_pos.size(); i++)
+      x(info_pos(i)) = GF_q(source(i));
+   back_substitute(x);
+   // determine gap symbols from the residue of their checks, and repeat
+   const int g = gap_pos.size();
+   if (g > 0)
+      {
+      array1gfq_t s(g);
+      for (int t = 0; t < g; t++)
+         s(t) = check(gap_row(t), x);
+      for (int t = 0; t < g; t++)
+         {
+         GF_q v = 0;
+         for (int u = 0; u < g; u++)
+            v += gap_inv(t, u) * s(u);
+         x(gap_pos(t)) = v;
+         }
+      back_substitute(x);
+      }
+   encoded.init(n);
+   for (int i = 0; i < n; i++)
+      encoded(i) = x(i);
+   }
+
+} // end namespace
+
+#include "gf.h"
+
+namespace libcomm {
+
+// Explicit Realizations
+#include <boost/preprocessor/seq/for_each.hpp>
+
+#define USING_GF(r, x, type) \
+      using libbase::type;
+
+BOOST_PP_SEQ_FOR_EACH(USING_GF, x, GF_TYPE_SEQ)
+
+#define INSTANTIATE(r, x, type) \
+      template class ldpc_encoder<type>;
+
+BOOST_PP_SEQ_FOR_EACH(INSTANTIATE, x, GF_TYPE_SEQ)
+
+} // end namespace
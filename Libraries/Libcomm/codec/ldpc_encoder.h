@@ -0,0 +1,131 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ldpc_encoder_h
+#define __ldpc_encoder_h
+
+#include "config.h"
+#include "vector.h"
+#include "matrix.h"
+
+namespace libcomm {
+
+/*!
+ * \brief   Sparse LDPC Encoder.
+ * \author  Johann Briffa
+ *
+ * Systematic encoder working directly on a sparse parity-check matrix H
+ * over GF(2^m), following the approximate lower-triangulation approach of
+ * Richardson and Urbanke, "Efficient encoding of low-density parity-check
+ * codes", IEEE Trans. IT, 2001.
+ *
+ * At initialization, H is triangulated greedily: a check with a single
+ * unknown symbol determines that symbol; when no such check exists, all
+ * but one of the unknown symbols in a check of least remaining degree are
+ * declared free. Structured codes (e.g. dual-diagonal or staircase parity)
+ * triangulate without any free parity symbols. The checks left over at the
+ * end are linear in the free symbols; a small dense system over these
+ * (the 'gap') chooses which free symbols are parity, leaving the rest as
+ * information symbols.
+ *
+ * Encoding then consists of one back-substitution pass with the gap symbols
+ * set to zero, solving the gap system for the actual gap symbols, and a
+ * second back-substitution pass. The cost is linear in the number of
+ * non-zero entries in H, plus the square of the gap; no generator matrix
+ * is needed.
+ *
+ * \note Since the field has characteristic 2, negation is the identity and
+ * is omitted throughout.
+ */
+
+template <class GF_q>
+class ldpc_encoder {
+public:
+   /*! \name Type definitions */
+   typedef libbase::vector<int> array1i_t;
+   typedef libbase::vector<array1i_t> array1vi_t;
+   typedef libbase::vector<GF_q> array1gfq_t;
+   // @}
+private:
+   /*! \name Internal representation */
+   int n; //!< Code length
+   array1vi_t row_pos; //!< Column indices of non-zero entries, per row of H
+   libbase::vector<array1gfq_t> row_val; //!< Non-zero entries, per row of H
+   array1i_t step_row; //!< Check used at each back-substitution step
+   array1i_t step_col; //!< Symbol determined at each back-substitution step
+   array1i_t info_pos; //!< Positions of information symbols
+   array1i_t gap_pos; //!< Positions of gap (free parity) symbols
+   array1i_t gap_row; //!< Checks that determine the gap symbols
+   libbase::matrix<GF_q> gap_inv; //!< Inverse of gap system matrix
+   // @}
+private:
+   /*! \name Internal functions */
+   //! Inner product of row 'i' of H with 'x'
+   GF_q check(const int i, const array1gfq_t& x) const
+      {
+      GF_q s = 0;
+      for (int j = 0; j < row_pos(i).size(); j++)
+         s += row_val(i)(j) * x(row_pos(i)(j));
+      return s;
+      }
+   void back_substitute(array1gfq_t& x) const;
+   // @}
+public:
+   /*! \name Constructors / Destructors */
+   ldpc_encoder() :
+      n(0)
+      {
+      }
+   // @}
+
+   /*! \brief Set up encoder for the given parity-check matrix
+    * \param H Parity-check matrix
+    * \param N_m Positions of non-zero entries in each row (counting from 1)
+    * \param M_n Positions of non-zero entries in each column (counting from 1)
+    */
+   void init(const libbase::matrix<GF_q>& H, const array1vi_t& N_m,
+         const array1vi_t& M_n);
+
+   //! Encode the given information sequence
+   void encode(const array1i_t& source, array1i_t& encoded) const;
+
+   /*! \name Information functions */
+   //! Code dimension
+   int dimension() const
+      {
+      return info_pos.size();
+      }
+   //! Positions of information symbols in the codeword
+   const array1i_t& get_info_positions() const
+      {
+      return info_pos;
+      }
+   //! Number of parity symbols not determined by back-substitution
+   int gap() const
+      {
+      return gap_pos.size();
+      }
+   // @}
+};
+
+} // end namespace
+
+#endif
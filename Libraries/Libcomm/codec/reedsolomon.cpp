@@ -87,247 +87,229 @@ void reedsolomon<GF_q>::softdecode(array1vd_t& ri, array1vd_t& ro)
    //determine the most likely symbol
    hd_functor(this->received_likelihoods, this->received_word_hd);
 #if DEBUG>=2
+   std::cout << std::endl << "The received word is given by:" << std::endl;
    this->received_word_hd.serialize(std::cout, ',');
    std::cout << std::endl;
 #endif
 
-   //we use the PGZ algorithm for decoding General BCH codes (note that RS codes are
-   //narrow-sense BCH codes.
-   //see
-   // http://en.wikipedia.org/wiki/BCH_code#Peterson_Gorenstein_Zierler_algorithm
-   //for details.
-
-   /*
-    * The algorithm works as follows:
-    * 1) calculate the syndrome of the received word
-    * 2) calculate the error locator polynominal
-    * 3) calculate the roots of the polynomial to get the error positions
-    * 4) calculate the error-values at these locations.
-    *
-    */
-
    // in case of decoding failure we simply return the received probabilities
    ro = this->received_likelihoods;
 
-   // Calculate the syndrome of the received word
-   // (and flag whether we decoded successfully)
-   libbase::vector<GF_q> syndrome_vec;
-   const bool dec_success =
-         libbase::linear_code_utils<GF_q, double>::compute_syndrome(
-               this->pchk_matrix, this->received_word_hd, syndrome_vec);
-
+   // correct the hard-decision word, if possible
+   libbase::vector<GF_q> decoded_word = this->received_word_hd;
+   if (correct(decoded_word))
+      {
 #if DEBUG>=2
-   std::cout << std::endl << "The received word is given by:" << std::endl;
-   this->received_word_hd.serialize(std::cout, ',');
-   std::cout << std::endl << "Its syndrome is given by:" << std::endl;
-   syndrome_vec.serialize(std::cout, ',');
+      std::cout << "This is the word we should have received:" << std::endl;
+      decoded_word.serialize(std::cout, ',');
+      std::cout << std::endl;
 #endif
-   if (dec_success)
-      {
-      // HD word must be correct, so set posteriors from this
+      // decoded HD word is consistent, so set posteriors from this
       ro = double(0);
       for (int i = 0; i < this->length_n; i++)
-         ro(i)(this->received_word_hd(i)) = double(1);
+         ro(i)(decoded_word(i)) = double(1);
       }
-   else //do some error correction as the syndrome is non-zero
-      {
-      //we can correct t errors and dmin=n-k+1.
-      //note that we have dim_pck=(n-k)>=2t
-      int t = (this->length_n - this->dim_k) / 2;
-
-      //the syndrome matrix
-      libbase::matrix<GF_q> syndrome_matrix;
-      //its REF form
-      libbase::matrix<GF_q> syndrome_ref_matrix;
-      //the determinant of the syndrome matrix
-      GF_q det = GF_q(1);
-
-      //this is now the PGZ algorithm whose aim it is to
-      //determine the error locator polynomial of the form
-      // \lambda(x)=1 + \lambda_1 x +\lambda_2 x^2 + .. + \lambda_w x^w
-      //where w<=t.
-      do {
-         //we now generate the t*(t+1) syndrome matrix
-         /*
-          *    [ s_1    s_2     s_3   ...     s_t   ]
-          *    [ s_2    s_3     s_4   ...   s_{t+1} ]
-          *  S=[ s_3    s_4     s_5   ...   s_{t+2} ]
-          *    [ ...    ...     ...   ...     ...   ]
-          *    [ s_t  s_{t+1} s_{t+2} ...  s_{2t-1} ]
-          *
-          */
-         syndrome_matrix.init(t, t + 1);
-         for (int rows = 0; rows < t; rows++)
-            {
-            for (int cols = 0; cols < t; cols++)
-               {
-               syndrome_matrix(rows, cols) = syndrome_vec(cols + rows);
-               }
-            }
-         //this is C_{tx1}=(s_{t+1},s_{t+2}, ... ,s_{2t-1}]^t
-         //we just stick this at the end of the syndrome matrix
-         for (int rows = 0; rows < t; rows++)
-            {
-            syndrome_matrix(rows, t) = syndrome_vec(t + rows);
-            }
-         //compute the determinant of the syndrome matrix
-         //which will in fact compute the solution to the following
-         //system
-         // S * [\lambda_1, \lambda_2,...,\lambda_t]^t=C_{tx1}^t
-         syndrome_ref_matrix = syndrome_matrix.reduce_to_ref();
-
-#if DEBUG>=2
-         std::cout << std::endl << "The syndrome matrix is given by:" << std::endl;
-         syndrome_matrix.serialize(std::cout, '\n');
-         std::cout << std::endl << "The syndrome matrix in REF is given by:" << std::endl;
-         syndrome_ref_matrix.serialize(std::cout, '\n');
-#endif
+   // Set input-referred posteriors from output-refered ones
+   ri = ro.extract(this->dim_pchk, this->dim_k);
+   }
 
-         det = GF_q(1);
-         for (int diag = 0; diag < t; diag++)
-            {
-            det *= syndrome_ref_matrix(diag, diag);
-            }
-         if (0 == det)
-            {
-            //empty error locator polynomial
-            t--;
-            }
-         } while ((GF_q(0) == det) && (t >= 1));
-
-      //only start decoding if det!=0
-      if (GF_q(0) != det)
+/*!
+ * \brief Hard-decision decoding of a single word, in place
+ * \param[in,out] word Received word, replaced by the corrected codeword
+ * \return True if the word is now a codeword (no decoding failure)
+ *
+ * Since RS codes are narrow-sense BCH codes, we use the usual algebraic
+ * decoder:
+ * 1) calculate the syndrome S_j = r(\alpha^j) for j=1..n-k
+ * 2) calculate the error locator polynomial
+ *    \lambda(x)=1 + \lambda_1 x +\lambda_2 x^2 + .. + \lambda_w x^w
+ *    using the Berlekamp-Massey algorithm
+ * 3) find the roots of the polynomial (Chien search); the error positions
+ *    are the i for which \lambda(\alpha^{-i})=0
+ * 4) calculate the error values at these positions (Forney's algorithm)
+ *
+ * Field arithmetic is done on integer representations, using log and
+ * antilog tables. The method does not change the object, so that it can be
+ * used concurrently on different words.
+ *
+ * \note The word is left unchanged on decoding failure.
+ */
+template <class GF_q>
+bool reedsolomon<GF_q>::correct(libbase::vector<GF_q>& word) const
+   {
+   const int n = this->length_n;
+   const int nk = this->dim_pchk;
+   const int q1 = GF_q::elements() - 1;
+   assert(word.size() == n);
+
+   // 1) Syndrome computation, S(j) = sum_i r_i \alpha^{ij} for j=1..n-k
+   array1i_t syndrome(nk + 1);
+   syndrome = 0;
+   bool zero_syndrome = true;
+   for (int j = 1; j <= nk; j++)
+      {
+      int s = 0;
+      int ij = 0; // (i*j) mod (q-1)
+      for (int i = 0; i < n; i++)
          {
-         //We can now read off the coefficients of the error locator polynomial
-         libbase::vector<GF_q> error_loc_poly;
-         error_loc_poly.init(t + 1);
-         error_loc_poly(0) = 1;
-         for (int rows = 1; rows <= t; rows++)
-            {
-            error_loc_poly(rows) = GF_q(syndrome_ref_matrix(t - rows, t));
-            }
-         //we now want to factor the error locator polynomial as follows:
-         //\lambda(x)=(X_w x +1)(X_{w-1} x +1) ... (X_1 x +1)
-         //          =\lamba_w x^w+\lamba_{w-1} x^{w-1}+...+\lambda_1 x + 1
-         //the X_i indicate the error positions of the received word as follows:
-         //Suppose that errors happened at positions, j_1, j_2, ..,j_w then
-         //X_i=\alpha^{j_i}.
-#if DEBUG>=2
-         std::cout
-         << std::endl << "The coeffs of the error locator polynomial are given by:" << std::endl;
-         error_loc_poly.serialize(std::cout, ',');
-#endif
-
-         //Use brute force and horner's scheme to determine the roots.
-         //we can stop as soon as we have found t=deg(\lambda(x)) roots
-         array1i_t error_pos;
-         error_pos.init(t);
-         GF_q alpha = GF_q(2); //represents \alpha
-         int counter = 0;
-         GF_q pow_alpha = GF_q(1); // represent \alpha^counter;
-         int rootsfound = 0;
-         while ((rootsfound < t) && (counter < this->length_n))
-            {
-            GF_q tmp_val = error_loc_poly(t);
-            for (int j = t; j > 0; j--)
-               {
-               tmp_val = tmp_val * pow_alpha + error_loc_poly(j - 1);
-               }
-            if (tmp_val == GF_q(0))
-               {
-               //we have found a root, \beta=\alpha^s of the error locator polynomial, eg say
-               //(X_1 \beta +1)=0 then X_1=\frac{1}{\beta}=\alpha^{-s}
-               //Now X_1=\alpha^{j_1} this means that j_1=-s and as we only deal with powers between
-               // 0 and q-1 we need to set j_1 to either 0 or (q-1)-s
-               int pos_inv = this->length_n - counter;
-               if (pos_inv == this->length_n)
-                  {
-                  pos_inv = 0;
-                  }
-               error_pos(rootsfound) = pos_inv;
-               rootsfound++;
-               }
-            //increment the counter
-            counter++;
-            //up the power
-            pow_alpha *= alpha;
-            }
-
-#if DEBUG>=2
-         if (rootsfound > 0)
-            {
-            std::cout << std::endl << "We found roots at:" << std::endl;
-            for (int loop1 = 0; loop1 < rootsfound; loop1++)
-               {
-               std::count << error_pos(loop1) << ", ";
-               }
-            }
-#endif
-         //only continue if we found some roots...
-         if (rootsfound != 0)
-            {
-            //we have found some roots and hence the error locations
-            //We can now work out the error values
-            libbase::matrix<GF_q> error_mat;
-            libbase::matrix<GF_q> error_ref_mat;
-            error_mat.init(this->dim_pchk, rootsfound + 1);
-            for (int rows = 0; rows < this->dim_pchk; rows++)
-               {
-               for (int cols = 0; cols < rootsfound; cols++)
-                  {
-                  error_mat(rows, cols) = this->pchk_matrix(rows,
-                        error_pos(cols));
-                  }
-               }
-            for (int rows = 0; rows < this->dim_pchk; rows++)
-               {
-               error_mat(rows, rootsfound) = syndrome_vec(rows);
-               }
-            //reduce to REF to obtain the error values
-            error_ref_mat = error_mat.reduce_to_ref();
-
+         const int r = word(i);
+         if (r != 0)
+            s ^= gf_exp(gf_log(r) + ij);
+         ij += j;
+         if (ij >= q1)
+            ij -= q1;
+         }
+      syndrome(j) = s;
+      if (s != 0)
+         zero_syndrome = false;
+      }
 #if DEBUG>=2
-            std::cout << std::endl << "The error matrix is given by:" << std::endl;
-            error_mat.serialize(std::cout, '\n');
-            std::cout << std::endl << "The error matrix in REF is given by:" << std::endl;
-            error_ref_mat.serialize(std::cout, '\n');
+   std::cout << "Its syndrome is given by:" << std::endl;
+   syndrome.serialize(std::cout, ',');
 #endif
-
-            //we only have a consistent solution if the following value is 0
-            if (error_ref_mat(rootsfound, rootsfound) == GF_q(0))
-               {
-               libbase::vector<GF_q> tmp_received_hd;
-               tmp_received_hd = this->received_word_hd;
-
-               //work out the proper code word
-               for (int rows = 0; rows < rootsfound; rows++)
-                  {
-                  int col = error_pos(rows);
-                  GF_q tmp_val = GF_q(tmp_received_hd(col))
-                        - error_ref_mat(rows, rootsfound);
-                  tmp_received_hd(col) = tmp_val;
-                  }
+   if (zero_syndrome)
+      return true;
+
+   // 2) Berlekamp-Massey algorithm, for the error locator polynomial
+   array1i_t lambda(nk + 1); // current connection polynomial
+   array1i_t prev(nk + 1); // connection polynomial before last length change
+   array1i_t tmp(nk + 1);
+   lambda = 0;
+   lambda(0) = 1;
+   prev = 0;
+   prev(0) = 1;
+   int L = 0; // current linear complexity
+   int shift = 1; // steps since last length change
+   int prev_d = 1; // discrepancy at last length change
+   for (int k = 0; k < nk; k++)
+      {
+      // compute discrepancy
+      int d = syndrome(k + 1);
+      for (int i = 1; i <= L; i++)
+         d ^= gf_mul(lambda(i), syndrome(k + 1 - i));
+      if (d == 0)
+         {
+         shift++;
+         continue;
+         }
+      // lambda(x) -= d/prev_d x^shift prev(x)
+      const int coeff = gf_div(d, prev_d);
+      if (2 * L <= k)
+         {
+         tmp = lambda;
+         for (int i = 0; i + shift <= nk; i++)
+            lambda(i + shift) ^= gf_mul(coeff, prev(i));
+         L = k + 1 - L;
+         prev = tmp;
+         prev_d = d;
+         shift = 1;
+         }
+      else
+         {
+         for (int i = 0; i + shift <= nk; i++)
+            lambda(i + shift) ^= gf_mul(coeff, prev(i));
+         shift++;
+         }
+      }
 #if DEBUG>=2
-               std::cout << "This is the word we should have received:" << std::endl;
-               tmp_received_hd.serialize(std::cout, ',');
-               std::cout << std::endl;
+   std::cout << std::endl << "The coeffs of the error locator polynomial are given by:" << std::endl;
+   lambda.serialize(std::cout, ',');
 #endif
-               // decoded HD word is consistent, so set posteriors from this
-               ro = double(0);
-               for (int i = 0; i < this->length_n; i++)
-                  ro(i)(tmp_received_hd(i)) = double(1);
-               }
-            }
+   // we can correct at most t=(n-k)/2 errors
+   if (L == 0 || 2 * L > nk || lambda(L) == 0)
+      return false;
+
+   // 3) Chien search: evaluate lambda(\alpha^{-i}) at all positions at once,
+   // accumulating one polynomial term at a time across the whole word
+   array1i_t eval(n);
+   eval = 1; // lambda(0) = 1
+   for (int j = 1; j <= L; j++)
+      {
+      if (lambda(j) == 0)
+         continue;
+      const int lj = gf_log(lambda(j));
+      int e = lj; // (log lambda_j - i*j) mod (q-1)
+      for (int i = 0; i < n; i++)
+         {
+         eval(i) ^= gf_exp(e);
+         e -= j % q1;
+         if (e < 0)
+            e += q1;
          }
       }
-   // Set input-referred posteriors from output-refered ones
-   ri = ro.extract(this->dim_pchk, this->dim_k);
-
+   array1i_t error_pos(L);
+   int rootsfound = 0;
+   for (int i = 0; i < n; i++)
+      if (eval(i) == 0)
+         {
+         if (rootsfound == L)
+            return false;
+         error_pos(rootsfound++) = i;
+         }
 #if DEBUG>=2
-   std::cout << std::endl << "The decoded word is given by:" << std::endl;
-   decoded.serialize(std::cout, ',');
-   std::cout << std::endl;
+   std::cout << std::endl << "We found " << rootsfound << " roots." << std::endl;
 #endif
+   // the locator must split into distinct factors within the code length
+   if (rootsfound != L)
+      return false;
+
+   // 4) Forney's algorithm: the error evaluator polynomial is
+   // omega(x) = S(x) lambda(x) mod x^L, where S(x) = S_1 + S_2 x + ...
+   // and for narrow-sense codes the error value at X=\alpha^i is
+   // e = omega(X^{-1}) / lambda'(X^{-1})
+   array1i_t omega(L);
+   for (int k = 0; k < L; k++)
+      {
+      int w = 0;
+      for (int i = 0; i <= k; i++)
+         w ^= gf_mul(lambda(i), syndrome(k + 1 - i));
+      omega(k) = w;
+      }
+   for (int r = 0; r < L; r++)
+      {
+      const int i = error_pos(r);
+      const int xinv = (q1 - i) % q1; // log of X^{-1}
+      // evaluate omega(X^{-1})
+      int num = 0;
+      for (int k = 0; k < L; k++)
+         if (omega(k) != 0)
+            num ^= gf_exp(gf_log(omega(k)) + (xinv * k) % q1);
+      // evaluate formal derivative lambda'(X^{-1}) (odd terms only)
+      int den = 0;
+      for (int k = 1; k <= L; k += 2)
+         if (lambda(k) != 0)
+            den ^= gf_exp(gf_log(lambda(k)) + (xinv * (k - 1)) % q1);
+      if (den == 0)
+         return false;
+      word(i) = int(word(i)) ^ gf_div(num, den);
+      }
+   return true;
+   }
+
+/*!
+ * \brief Hard-decision decoding of a sequence of words, in place
+ * \param[in,out] words Concatenation of received words, replaced by the
+ *                      corrected codewords
+ * \return Number of words that could not be decoded (and are left unchanged)
+ *
+ * This is meant for systems that decode many RS blocks at once; blocks are
+ * decoded in parallel where possible.
+ */
+template <class GF_q>
+int reedsolomon<GF_q>::decode_batch(libbase::vector<GF_q>& words) const
+   {
+   assertalways(words.size() % this->length_n == 0);
+   const int N = words.size() / this->length_n;
+   int failures = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+:failures)
+   for (int i = 0; i < N; i++)
+      {
+      libbase::indirect_vector<GF_q> word = words.segment(i * this->length_n,
+            this->length_n);
+      if (!correct(word))
+         failures++;
+      }
+   return failures;
    }
 
 template <class GF_q>
@@ -444,6 +426,21 @@ void reedsolomon<GF_q>::init()
     *
     */
 
+   //set up log and antilog tables for the decoder; the antilog table is
+   //doubled in length so that sums of two logs need no reduction
+   const int q1 = GF_q::elements() - 1;
+   this->gf_log.init(q1 + 1);
+   this->gf_exp.init(2 * q1);
+   this->gf_log(0) = 0; //note this is by convention and not used anywhere
+   GF_q pow_alpha = GF_q(1);
+   for (int i = 0; i < 2 * q1; i++)
+      {
+      this->gf_exp(i) = pow_alpha;
+      if (i < q1)
+         this->gf_log(pow_alpha) = i;
+      pow_alpha *= GF_q(2);
+      }
+
    //what's the dimension of the parity check matrix
    this->dim_pchk = (this->length_n - this->dim_k);
    this->pchk_matrix.init(dim_pchk, this->length_n);
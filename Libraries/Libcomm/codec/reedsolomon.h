@@ -43,7 +43,9 @@ namespace libcomm {
  * \author S Wesemeyer
  * This class will construct a Reed-Solomon code over F_{q} of length n and dimension k
  * Note that n is either q or q-1 and 1<k<n-1
- * The Berlekamp algorithm is used to decode any received word.
+ * The Berlekamp-Massey algorithm is used to decode any received word, with
+ * Chien search for the error positions and Forney's algorithm for the error
+ * values.
  *
  */
 template <class GF_q>
@@ -122,6 +124,11 @@ public:
    void softdecode(array1vd_t& ri, array1vd_t& ro);
    // @}
 
+   /*! \name Hard-decision decoding */
+   bool correct(libbase::vector<GF_q>& word) const;
+   int decode_batch(libbase::vector<GF_q>& words) const;
+   // @}
+
    /*! \name Codec information functions - fundamental */
    //! Input block size in symbols, ie the dimension of the code
    libbase::size_type<libbase::vector> input_block_size() const
@@ -213,6 +220,27 @@ private:
 
    //! Hard-decision box
    hard_decision<libbase::vector, double, GF_q> hd_functor;
+
+   //! Log table, giving the power of alpha for each non-zero field element
+   array1i_t gf_log;
+   //! Antilog table, giving alpha^i for 0<=i<2(q-1)
+   array1i_t gf_exp;
+
+   /*! \name Field arithmetic on integer representations */
+   int gf_mul(const int a, const int b) const
+      {
+      if (a == 0 || b == 0)
+         return 0;
+      return gf_exp(gf_log(a) + gf_log(b));
+      }
+   int gf_div(const int a, const int b) const
+      {
+      assert(b != 0);
+      if (a == 0)
+         return 0;
+      return gf_exp(gf_log(a) + GF_q::elements() - 1 - gf_log(b));
+      }
+   // @}
 };
 
 }
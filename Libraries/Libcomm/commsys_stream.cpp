@@ -38,7 +38,7 @@ namespace libcomm {
 // Communication System Interface
 
 /*! \brief Advance the stream, skipping over last decoded frame
- * \param[in] recevied      The received stream (to be updated)
+ * \param[in] recevied      The received stream buffer (to be updated)
  * \param[in] oldoffset     The offset value that applied for the last decoding
  * \param[in] drift         The estimated drift at the end of decoded frame
  * \param[in] newoffset     The offset value that applies for the next decoding
@@ -46,27 +46,26 @@ namespace libcomm {
  * This method initializes the received stream, if empty, by the new offset.
  * Otherwise, it will skip over all material from the last decoding that is
  * no longer needed (keeping the last segment as required by the new offset).
+ * Material is consumed from the front of the buffer, so that what is kept is
+ * neither copied nor moved.
  */
 template <class S, template <class > class C, class real>
-void commsys_stream<S, C, real>::stream_advance(C<S>& received,
+void commsys_stream<S, C, real>::stream_advance(
+      libbase::circular_buffer<S>& received,
       const libbase::size_type<C>& oldoffset,
       const libbase::size_type<C>& drift,
       const libbase::size_type<C>& newoffset)
    {
-   C<S> received_prev;
    if (received.size() == 0)
       {
-      received_prev.init(newoffset);
-      received_prev = 0; // value is irrelevant as this is not used
+      received.push_back(newoffset, S(0)); // value is irrelevant as this is not used
       }
    else
       {
       const int tau = this->output_block_size();
       const int start = tau + drift + oldoffset - newoffset;
-      const int length = received.size() - start;
-      received_prev = received.extract(start, length);
+      received.pop_front(start);
       }
-   received = received_prev;
    // Tell user what we're doing
 #if DEBUG>=2
    std::cerr << "DEBUG (commsys_stream): old offset = " << oldoffset << std::endl;
@@ -26,6 +26,7 @@
 #include "modem/stream_modulator.h"
 #include "channel_stream.h"
 #include "codec/codec_softout.h"
+#include "circular_buffer.h"
 
 namespace libcomm {
 
@@ -126,7 +127,8 @@ public:
    // @}
 
    /*! \name Communication System Interface - Stream Extensions */
-   void stream_advance(C<S>& received, const libbase::size_type<C>& oldoffset,
+   void stream_advance(libbase::circular_buffer<S>& received,
+         const libbase::size_type<C>& oldoffset,
          const libbase::size_type<C>& drift,
          const libbase::size_type<C>& newoffset);
    void compute_priors(const C<double>& eof_post,
@@ -119,7 +119,8 @@ void ssis<S, matrix, dbl>::doembed(const int N, const matrix<int>& data,
       }
    // Initialize results matrix
    tx.init(this->input_block_size());
-   // Modulate encoded stream
+   // Modulate encoded stream (rows are independent)
+#pragma omp parallel for
    for (int i = 0; i < rows; i++)
       for (int j = 0; j < cols; j++)
          tx(i, j) = embed(data(i, j), pp_host(i, j), u(i, j), A);
@@ -148,6 +149,7 @@ void ssis<S, matrix, dbl>::doextract(const channel<S, matrix>& chan,
       // Create a set of all possible transmitted symbols, at each timestep
       matrix<vector<S> > tx;
       libbase::allocate(tx, rows, cols, M);
+#pragma omp parallel for
       for (int i = 0; i < rows; i++)
          for (int j = 0; j < cols; j++)
             for (int x = 0; x < M; x++)
@@ -47,6 +47,11 @@ class ssis : public blockembedder<S, C, dbl> {
  *
  * Matrix implementation of Marvel et al.'s SSIS algorithm for data embedding
  * in images.
+ *
+ * The uniform sequence for each block is drawn sequentially from a single
+ * generator, so that a given seed always gives the same sequence; the
+ * conversion to Gaussian values, which dominates the cost of embedding and
+ * extraction, is done for rows in parallel.
  */
 
 template <class S, class dbl>
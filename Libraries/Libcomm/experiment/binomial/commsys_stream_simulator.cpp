@@ -37,6 +37,77 @@ namespace libcomm {
 #  define DEBUG 1
 #endif
 
+// Internal functions
+
+/*!
+ * \brief Generate and transmit the next frame
+ * \param[out] frame   Source, received sequence, and boundary drift info
+ *
+ * This only uses transmitter-side objects (source generator, encoder-side
+ * commsys, and the decoder-side transmit channel), so it can be run
+ * concurrently with decoding.
+ */
+template <class S, class R, class real>
+void commsys_stream_simulator<S, R, real>::generate_frame(frame_t& frame)
+   {
+   // Get access to the decoder-side commsys object in stream-oriented mode
+   commsys_stream<S, libbase::vector, real>& sys_dec = getsys_stream();
+   // Create next source frame
+   frame.source = Base::createsource();
+   // Encode -> Map -> Modulate next frame
+   const array1s_t transmitted = sys_enc->encode_path(frame.source);
+   // Transmit next frame
+   frame.received = sys_dec.transmit(transmitted);
+   // keep data for codeword boundary analysis if this is indicated
+   if (dynamic_cast<fidelity_pos*>(this))
+      {
+      // get codeword boundary positions from modem (encoder-side)
+      const array1i_t boundary_pos =
+            sys_enc->getmodem_stream().get_boundaries();
+      // get actual drift at codeword boundary positions from channel (decoder-side)
+      frame.act_bdry_drift = sys_dec.gettxchan_stream().get_drift(
+            boundary_pos);
+      }
+   }
+
+/*!
+ * \brief Append a generated frame to the received stream
+ * \param[in] frame   Frame as returned by generate_frame()
+ */
+template <class S, class R, class real>
+void commsys_stream_simulator<S, R, real>::append_frame(const frame_t& frame)
+   {
+   // shorthand for transmitted and received frame sizes
+   const int tau = getsys_stream().output_block_size();
+   const int rho = frame.received.size();
+   // store what we need to keep
+   source.push_back(frame.source);
+   if (dynamic_cast<fidelity_pos*>(this))
+      act_bdry_drift.push_back(frame.act_bdry_drift);
+   received.push_back(frame.received);
+   actual_drift.push_back(rho - tau);
+   // update counters
+   frames_encoded++;
+   // Tell user what we're doing
+#if DEBUG>=2
+   std::cerr << "DEBUG (commsys_stream_simulator): Actual received frame = " << rho << std::endl;
+   std::cerr << "DEBUG (commsys_stream_simulator): Frames encoded = " << frames_encoded << std::endl;
+#endif
+   }
+
+/*!
+ * \brief Generate frames ahead of decoder, up to the pipeline depth
+ */
+template <class S, class R, class real>
+void commsys_stream_simulator<S, R, real>::fill_pipeline()
+   {
+   while (int(pending.size()) < pipeline_depth)
+      {
+      pending.push_back(frame_t());
+      generate_frame(pending.back());
+      }
+   }
+
 // Experiment handling
 
 /*!
@@ -99,44 +170,22 @@ void commsys_stream_simulator<S, R, real>::sample(libbase::vector<double>& resul
 #endif
    // Append required segment by simulating frame transmission
    // Also make sure that we have transmitted the frame corresponding to the
-   // received one.
+   // received one. Frames generated ahead are used first, where available.
    // NOTE: it does not matter if we transmit more frames than needed for a
    // terminated stream (and we most likely will), as once we set the eof prior
    // the decoder will know at which point to stop in the received sequence.
    for (int left = length - received.size(); left > 0 || source.empty();)
       {
-      // Create next source frame
-      const array1i_t source_next = Base::createsource();
-      // Encode -> Map -> Modulate next frame
-      const array1s_t transmitted = sys_enc->encode_path(source_next);
-      // Transmit next frame
-      const array1s_t received_next = sys_dec.transmit(transmitted);
-      // keep data for codeword boundary analysis if this is indicated
-      if (rc)
+      if (pending.empty())
          {
-         // get codeword boundary positions from modem (encoder-side)
-         const array1i_t boundary_pos =
-               sys_enc->getmodem_stream().get_boundaries();
-         // get actual drift at codeword boundary positions from channel (decoder-side)
-         const array1i_t act_drift = sys_dec.gettxchan_stream().get_drift(
-               boundary_pos);
-         // store what we need to keep
-         act_bdry_drift.push_back(act_drift);
+         pending.push_back(frame_t());
+         generate_frame(pending.back());
          }
-      // shorthand for received frame size
-      const int rho = received_next.size();
-      // store what we need to keep
-      source.push_back(source_next);
-      received = concatenate(received, received_next);
-      actual_drift.push_back(rho - tau);
-      // update counters
-      frames_encoded++;
-      left -= rho;
-      // Tell user what we're doing
+      left -= pending.front().received.size();
+      append_frame(pending.front());
+      pending.pop_front();
 #if DEBUG>=2
-      std::cerr << "DEBUG (commsys_stream_simulator): Actual received frame = " << rho << std::endl;
       std::cerr << "DEBUG (commsys_stream_simulator): Remaining length = " << left << std::endl;
-      std::cerr << "DEBUG (commsys_stream_simulator): Frames encoded = " << frames_encoded << std::endl;
 #endif
       }
    // If it's the last frame in a terminated stream, set eof prior accordingly.
@@ -167,7 +216,7 @@ void commsys_stream_simulator<S, R, real>::sample(libbase::vector<double>& resul
          }
       }
    // Shorthand for curent segment in received sequences
-   const array1s_t& received_segment = received.extract(0, length);
+   const array1s_t& received_segment = received.segment(0, length);
 
    // Initialise result vector
    result.init(this->count());
@@ -175,97 +224,104 @@ void commsys_stream_simulator<S, R, real>::sample(libbase::vector<double>& resul
    // Initialize extrinsic information vectors (modem + codec alphabets)
    array1vd_t ptable_ext_modem;
    array1vd_t ptable_ext_codec;
-   // Inner code (modem) iterations
-   for (int iter_modem = 0; iter_modem < sys_dec.sys_iter(); iter_modem++)
+   // Decode this frame, while generating upcoming ones if pipelining
+#pragma omp parallel sections if(pipeline_depth > 0)
       {
-      // ** Inner code (modem class) **
-      // Demodulate
-      array1vd_t ptable_post_modem;
-      array1d_t sof_post;
-      sys_dec.getmodem_stream().demodulate(*sys_dec.getrxchan(),
-            received_segment, lookahead, sof_prior, eof_prior, ptable_ext_modem,
-            ptable_post_modem, sof_post, eof_post, offset);
-      // Normalize posterior information
-      libbase::normalize_results(ptable_post_modem, ptable_post_modem);
-      // Inverse Map posterior information
-      array1vd_t ptable_post_codec;
-      sys_dec.getmapper()->inverse(ptable_post_modem, ptable_post_codec);
-      // Compute extrinsic information from uncoded posteriors and priors
-      // (codec alphabet)
-      libbase::compute_extrinsic(ptable_ext_codec, ptable_post_codec,
-            ptable_ext_codec);
-      // Pass extrinsic information through mapper
-      sys_dec.getmapper()->transform(ptable_ext_codec, ptable_ext_modem);
-      // Mark mapper as clean (we will need to use again this cycle)
-      sys_dec.getmapper()->mark_as_clean();
-
-      // and perform codeword boundary analysis if this is indicated
-      if (rc)
+#pragma omp section
+      fill_pipeline();
+#pragma omp section
+      // Inner code (modem) iterations
+      for (int iter_modem = 0; iter_modem < sys_dec.sys_iter(); iter_modem++)
          {
-         // get estimated drift pdfs
-         array1vd_t post_pdftable;
-         sys_dec.getmodem_stream().get_post_drift_pdf(post_pdftable, offset);
-         // get most probable estimated drift positions
-         array1i_t est_drift(post_pdftable.size());
-         for (int i = 0; i < post_pdftable.size(); i++)
-            est_drift(i) = commsys_stream<S, libbase::vector, real>::estimate_drift(post_pdftable(i),
-                  offset);
-         // get actual drift at codeword boundary positions to compare against
-         assert(!act_bdry_drift.empty());
-         const array1i_t act_drift = act_bdry_drift.front();
-         // Tell user what we're doing
+         // ** Inner code (modem class) **
+         // Demodulate
+         array1vd_t ptable_post_modem;
+         array1d_t sof_post;
+         sys_dec.getmodem_stream().demodulate(*sys_dec.getrxchan(),
+               received_segment, lookahead, sof_prior, eof_prior, ptable_ext_modem,
+               ptable_post_modem, sof_post, eof_post, offset);
+         // Normalize posterior information
+         libbase::normalize_results(ptable_post_modem, ptable_post_modem);
+         // Inverse Map posterior information
+         array1vd_t ptable_post_codec;
+         sys_dec.getmapper()->inverse(ptable_post_modem, ptable_post_codec);
+         // Compute extrinsic information from uncoded posteriors and priors
+         // (codec alphabet)
+         libbase::compute_extrinsic(ptable_ext_codec, ptable_post_codec,
+               ptable_ext_codec);
+         // Pass extrinsic information through mapper
+         sys_dec.getmapper()->transform(ptable_ext_codec, ptable_ext_modem);
+         // Mark mapper as clean (we will need to use again this cycle)
+         sys_dec.getmapper()->mark_as_clean();
+
+         // and perform codeword boundary analysis if this is indicated
+         if (rc)
+            {
+            // get estimated drift pdfs
+            array1vd_t post_pdftable;
+            sys_dec.getmodem_stream().get_post_drift_pdf(post_pdftable, offset);
+            // get most probable estimated drift positions
+            array1i_t est_drift(post_pdftable.size());
+            for (int i = 0; i < post_pdftable.size(); i++)
+               est_drift(i) = commsys_stream<S, libbase::vector, real>::estimate_drift(post_pdftable(i),
+                     offset);
+            // get actual drift at codeword boundary positions to compare against
+            assert(!act_bdry_drift.empty());
+            const array1i_t act_drift = act_bdry_drift.front();
+            // Tell user what we're doing
 #if DEBUG>=4
-         std::cerr << "DEBUG (commsys_stream_simulator): act bdry drift = " << act_drift << std::endl;
-         std::cerr << "DEBUG (commsys_stream_simulator): est bdry drift = " << est_drift << std::endl;
+            std::cerr << "DEBUG (commsys_stream_simulator): act bdry drift = " << act_drift << std::endl;
+            std::cerr << "DEBUG (commsys_stream_simulator): est bdry drift = " << est_drift << std::endl;
 #endif
-         // accumulate results
-         libbase::indirect_vector<double> result_segment = result.segment(
-               R::count() * iter_modem, R::count());
-         rc->updateresults(result_segment, act_drift, est_drift);
-         }
+            // accumulate results
+            libbase::indirect_vector<double> result_segment = result.segment(
+                  R::count() * iter_modem, R::count());
+            rc->updateresults(result_segment, act_drift, est_drift);
+            }
 
-      // ** Outer code (codec class) **
-      // Get source message to compare against
-      assert(!source.empty());
-      array1i_t source_this = source.front();
-      // Translate
-      sys_dec.getcodec()->init_decoder(ptable_ext_codec);
-      // Perform necessary number of codec iterations
-      array1i_t decoded;
-      array1vd_t ri_codec;
-      array1vd_t ro_codec;
-      for (int iter_codec = 0; iter_codec < sys_dec.num_iter(); iter_codec++)
-         {
-         // Perform soft-output decoding
-         sys_dec.getcodec_softout().softdecode(ri_codec, ro_codec);
-         // Compute hard-decision for results gatherer
-         hd_functor(ri_codec, decoded);
-         // Update results if necessary
-         if (!rc)
+         // ** Outer code (codec class) **
+         // Get source message to compare against
+         assert(!source.empty());
+         array1i_t source_this = source.front();
+         // Translate
+         sys_dec.getcodec()->init_decoder(ptable_ext_codec);
+         // Perform necessary number of codec iterations
+         array1i_t decoded;
+         array1vd_t ri_codec;
+         array1vd_t ro_codec;
+         for (int iter_codec = 0; iter_codec < sys_dec.num_iter(); iter_codec++)
             {
-            libbase::indirect_vector<double> result_segment = result.segment(
-                  R::count() * (iter_modem * sys_dec.num_iter() + iter_codec),
-                  R::count());
-            R::updateresults(result_segment, source_this, decoded);
+            // Perform soft-output decoding
+            sys_dec.getcodec_softout().softdecode(ri_codec, ro_codec);
+            // Compute hard-decision for results gatherer
+            hd_functor(ri_codec, decoded);
+            // Update results if necessary
+            if (!rc)
+               {
+               libbase::indirect_vector<double> result_segment = result.segment(
+                     R::count() * (iter_modem * sys_dec.num_iter() + iter_codec),
+                     R::count());
+               R::updateresults(result_segment, source_this, decoded);
+               }
+            }
+         // Normalize posterior information
+         libbase::normalize_results(ro_codec, ro_codec);
+         // Pass posterior information through mapper
+         array1vd_t ro_modem;
+         sys_dec.getmapper()->transform(ro_codec, ro_modem);
+         // Compute extrinsic information from encoded posteriors and priors
+         // (modem alphabet)
+         libbase::compute_extrinsic(ptable_ext_modem, ro_modem, ptable_ext_modem);
+         // Inverse Map extrinsic information
+         sys_dec.getmapper()->inverse(ptable_ext_modem, ptable_ext_codec);
+         // Keep record of what we last simulated
+         this->last_event = concatenate(source_this, decoded);
+         // If this was not the last iteration, mark components as clean
+         if (iter_modem + 1 < sys_dec.sys_iter())
+            {
+            sys_dec.getmodem()->mark_as_clean();
+            sys_dec.getmapper()->mark_as_clean();
             }
-         }
-      // Normalize posterior information
-      libbase::normalize_results(ro_codec, ro_codec);
-      // Pass posterior information through mapper
-      array1vd_t ro_modem;
-      sys_dec.getmapper()->transform(ro_codec, ro_modem);
-      // Compute extrinsic information from encoded posteriors and priors
-      // (modem alphabet)
-      libbase::compute_extrinsic(ptable_ext_modem, ro_modem, ptable_ext_modem);
-      // Inverse Map extrinsic information
-      sys_dec.getmapper()->inverse(ptable_ext_modem, ptable_ext_codec);
-      // Keep record of what we last simulated
-      this->last_event = concatenate(source_this, decoded);
-      // If this was not the last iteration, mark components as clean
-      if (iter_modem + 1 < sys_dec.sys_iter())
-         {
-         sys_dec.getmodem()->mark_as_clean();
-         sys_dec.getmapper()->mark_as_clean();
          }
       }
 
@@ -326,6 +382,8 @@ std::string commsys_stream_simulator<S, R, real>::description() const
       default:
          break;
       }
+   if (pipeline_depth > 0)
+      sout << ", pipelined (" << pipeline_depth << " frames ahead)";
    return sout.str();
    }
 
@@ -337,7 +395,7 @@ std::ostream& commsys_stream_simulator<S, R, real>::serialize(
    {
    // format version
    sout << "# Version" << std::endl;
-   sout << 2 << std::endl;
+   sout << 3 << std::endl;
    sout << "# Streaming mode (0=open, 1=reset, 2=terminated)" << std::endl;
    sout << stream_mode << std::endl;
    switch (stream_mode)
@@ -353,6 +411,8 @@ std::ostream& commsys_stream_simulator<S, R, real>::serialize(
       default:
          break;
       }
+   sout << "# Number of frames to generate ahead of decoder (0=no pipelining)" << std::endl;
+   sout << pipeline_depth << std::endl;
    // continue writing underlying system
    Base::serialize(sout);
    return sout;
@@ -366,6 +426,8 @@ std::ostream& commsys_stream_simulator<S, R, real>::serialize(
  * \version 1 Added version numbering; added frame count to stream reset
  *
  * \version 2 Changed format to include stream mode, and terminating streams
+ *
+ * \version 3 Added pipeline depth
  */
 
 template <class S, class R, class real>
@@ -412,6 +474,14 @@ std::istream& commsys_stream_simulator<S, R, real>::serialize(std::istream& sin)
             break;
          }
       }
+   // *** Pipelining
+   // reset (valid for versions < 3)
+   pipeline_depth = 0;
+   if (version >= 3)
+      {
+      sin >> libbase::eatcomments >> pipeline_depth >> libbase::verify;
+      assertalways(pipeline_depth >= 0);
+      }
    // continue reading underlying system
    Base::serialize(sin);
    // check that components are stream-oriented
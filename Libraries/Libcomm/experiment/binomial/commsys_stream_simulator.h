@@ -45,6 +45,15 @@ namespace libcomm {
  * previous frame simulation. The a-priori end-of-frame information is set
  * according to the distribution provided by the channel.
  *
+ * Optionally, the simulator can work in a pipelined mode, where a number of
+ * upcoming frames are generated and transmitted while the current frame is
+ * being decoded. Frame generation only depends on the transmitter side
+ * (source, encoder copy, and transmit channel), so this runs concurrently
+ * with the decoder when built with OpenMP. Frames generated ahead are kept
+ * in a bounded queue, and are appended to the received stream as needed.
+ * Note that parallel regions within the decoder are not nested by default,
+ * so this mode is best used with decoders that do not parallelize internally.
+ *
  * \tparam S Channel symbol type
  * \tparam R Results collector type
  * \tparam real Floating-point type for metric computer interface
@@ -72,10 +81,19 @@ private:
       stream_mode_undefined
    } stream_mode; //!< enum indicating streaming mode
    int N; //!< number of frames to reset or end of stream
+   int pipeline_depth; //!< number of frames to generate ahead of decoder (0 = no pipelining)
+   // @}
+   /*! \name Internal representation */
+   //! Transmitted frame, as generated ahead of its use
+   struct frame_t {
+      array1i_t source; //!< Message sequence
+      array1s_t received; //!< Received sequence
+      array1i_t act_bdry_drift; //!< Actual channel drift at codeword boundaries
+   };
    // @}
    /*! \name Internally-used objects */
    std::list<array1i_t> source; //!< List of message sequences in order of transmission
-   array1s_t received; //!< Received sequence as a stream
+   libbase::circular_buffer<S> received; //!< Received sequence as a stream
    array1d_t eof_post; //!< Centralized posterior probabilities at end-of-frame
    libbase::size_type<libbase::vector> offset; //!< Index offset for eof_post
    libbase::size_type<libbase::vector> estimated_drift; //!< Estimated drift in last decoded frame
@@ -86,6 +104,7 @@ private:
    int frames_encoded; //!< Number of frames encoded since stream reset
    int frames_decoded; //!< Number of frames decoded since stream reset
    hard_decision<libbase::vector, double, int> hd_functor; //!< Hard-decision box
+   std::list<frame_t> pending; //!< Frames generated ahead, not yet in received stream
    // @}
 
 protected:
@@ -107,10 +126,12 @@ protected:
       {
       // clear internal state
       source.clear();
-      received.init(0);
+      received.clear();
       eof_post.init(0);
       offset = libbase::size_type<libbase::vector>(0);
       estimated_drift = libbase::size_type<libbase::vector>(0);
+      // discard any frames generated ahead
+      pending.clear();
       // reset drift trackers
       act_bdry_drift.clear();
       actual_drift.clear();
@@ -130,6 +151,12 @@ protected:
       }
    // @}
 
+   /*! \name Internal functions */
+   void generate_frame(frame_t& frame);
+   void append_frame(const frame_t& frame);
+   void fill_pipeline();
+   // @}
+
    // System Interface for Results
    int get_symbolsperframe() const
       {
@@ -143,17 +170,17 @@ protected:
 public:
    /*! \name Constructors / Destructors */
    commsys_stream_simulator(const commsys_stream_simulator<S, R, real>& c) :
-         commsys_simulator<S, R>(c), stream_mode(c.stream_mode), N(c.N), source(c.source), received(
-               c.received), eof_post(c.eof_post), offset(c.offset), estimated_drift(
+         commsys_simulator<S, R>(c), stream_mode(c.stream_mode), N(c.N), pipeline_depth(
+               c.pipeline_depth), source(c.source), received(c.received), eof_post(c.eof_post), offset(c.offset), estimated_drift(
                c.estimated_drift), act_bdry_drift(c.act_bdry_drift), actual_drift(
                c.actual_drift), drift_error(c.drift_error), frames_encoded(
-               c.frames_encoded), frames_decoded(c.frames_decoded)
+               c.frames_encoded), frames_decoded(c.frames_decoded), pending(c.pending)
       {
       sys_enc = boost::dynamic_pointer_cast<
             commsys_stream<S, libbase::vector, real> >(c.sys_enc->clone());
       }
    commsys_stream_simulator() :
-         stream_mode(stream_mode_open), N(0)
+         stream_mode(stream_mode_open), N(0), pipeline_depth(0)
       {
       reset();
       }
@@ -179,6 +206,8 @@ public:
       assert(sys_enc);
       // set the TX channel parameter only (we should not need to use the RX)
       sys_enc->gettxchan()->set_parameter(x);
+      // discard any frames generated ahead with the old parameter
+      pending.clear();
       }
    // @}
 
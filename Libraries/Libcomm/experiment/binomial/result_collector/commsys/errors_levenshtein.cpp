@@ -44,7 +44,9 @@ void errors_levenshtein::updateresults(libbase::vector<double>& result,
    {
    // Count errors
    const int hd = libbase::hamming(source, decoded);
-   const int ld = libbase::levenshtein(source, decoded);
+   // The sequences have equal length, so the distance is at most the Hamming
+   // distance, and an optimal alignment never drifts by more than half that
+   const int ld = hd ? libbase::levenshtein(source, decoded, hd / 2) : 0;
    // Estimate the SER, LD, FER
    result(0) += hd;
    result(1) += ld;
@@ -66,13 +66,16 @@ libbase::vector<int> exit_computer<S>::createsource()
 /*!
  * \brief Create table of Gaussian-distributed priors
  * \param[out] priors   Table of Gaussian-distributed priors for given input
+ * \param[in] r         Random generator to use
+ * \param[in] sigma     Sigma value for binary priors
  * \param[in] tx        Vector of transmitted symbols
  * \param[in] N         Required length of sequence of priors
  * \param[in] q         Alphabet size
  */
 template <class S>
 libbase::vector<libbase::vector<double> > exit_computer<S>::createpriors(
-      const array1i_t& tx, const int N, const int q)
+      libbase::random& r, const double sigma, const array1i_t& tx,
+      const int N, const int q)
    {
    // determine sizes
    const int k = int(log2(q));
@@ -92,7 +95,7 @@ libbase::vector<libbase::vector<double> > exit_computer<S>::createpriors(
       {
       // generate random LLR for given bit
       // Note: LLR is interpreted as ln(Pr(0)/Pr(1))
-      const double llr = src.gval(sigma) + (tx_b(i) == 0 ? mu : -mu);
+      const double llr = r.gval(sigma) + (tx_b(i) == 0 ? mu : -mu);
       // determine binary priors from LLR
       const double lr = exp(llr); // = p0/p1 = p0/(1-p0) = (1-p1)/p1
       priors_b(i)(0) = lr / (1 + lr); // = p0
@@ -137,17 +140,23 @@ double exit_computer<S>::compute_mutual_information(const array1i_t& x,
    }
 
 /*!
- * \brief Determine the distribution statistics for 'p' where the binary
- *        decomposition of 'x' is equal to 'value'
+ * \brief Determine the distribution statistics for the binary LLRs in 'p',
+ *        separately for where the binary decomposition of 'x' is 0 and 1
  * \param x The known transmitted sequence
  * \param p The probability table at the receiving end p(y|x)
- * \param value The conditional value for the transmitted sequence
- * \param sigma The standard deviation of the distribution
- * \param mu The mean of the distribution
+ * \param sigma0 The standard deviation of the distribution for value 0
+ * \param mu0 The mean of the distribution for value 0
+ * \param sigma1 The standard deviation of the distribution for value 1
+ * \param mu1 The mean of the distribution for value 1
+ *
+ * The binary probabilities for each bit are aggregated from each symbol's
+ * probabilities as they are needed, and their LLRs accumulated directly;
+ * the binary decomposition of the table is never held in full.
  */
 template <class S>
 void exit_computer<S>::compute_statistics(const array1i_t& x,
-      const array1vd_t& p, const int value, double& sigma, double& mu)
+      const array1vd_t& p, double& sigma0, double& mu0, double& sigma1,
+      double& mu1)
    {
    // determine sizes
    const int N = p.size();
@@ -157,26 +166,24 @@ void exit_computer<S>::compute_statistics(const array1i_t& x,
    assert(x.size() == N);
    const int k = int(log2(q));
    assert(q == (1<<k));
-   // obtain binary decomposition of symbols and probabilities
-   array1i_t xb;
-   array1vd_t pb;
-   libbase::symbol_converter<double, double> converter(2, q);
-   converter.divide_symbols(x, xb);
-   converter.divide_probabilities(p, pb);
-   // iterate through each bit in the table
-   libbase::rvstatistics rv;
-   for (int i = 0; i < k * N; i++)
-      {
-      if(xb(i) == value)
+   // iterate through each bit of each symbol in the table
+   libbase::rvstatistics rv[2];
+   for (int i = 0; i < N; i++)
+      for (int b = 0; b < k; b++)
          {
+         // aggregate binary probabilities for this bit
+         double pb[2] = { 0, 0 };
+         for (int d = 0; d < q; d++)
+            pb[(d >> b) & 1] += p(i)(d);
          // compute LLR from probabilities
-         const double llr = log(pb(i)(0)/pb(i)(1));
-         rv.insert(llr);
+         const double llr = log(pb[0] / pb[1]);
+         rv[(x(i) >> b) & 1].insert(llr);
          }
-      }
    // store results
-   sigma = rv.sigma();
-   mu = rv.mean();
+   sigma0 = rv[0].sigma();
+   mu0 = rv[0].mean();
+   sigma1 = rv[1].sigma();
+   mu1 = rv[1].mean();
    }
 
 /*!
@@ -190,67 +197,78 @@ template <class S>
 void exit_computer<S>::compute_results(const array1i_t& x,
       const array1vd_t& pin, const array1vd_t& pout, array1d_t& result) const
    {
-   assert(result.size() == count());
+   assert(result.size() == count_point());
    // Compute results
    result(0) = compute_mutual_information(x, pin);
    result(1) = compute_mutual_information(x, pout);
    if (compute_llr_statistics)
       {
-      compute_statistics(x, pin, 0, result(2), result(3));
-      compute_statistics(x, pin, 1, result(4), result(5));
-      compute_statistics(x, pout, 0, result(6), result(7));
-      compute_statistics(x, pout, 1, result(8), result(9));
+      compute_statistics(x, pin, result(2), result(3), result(4), result(5));
+      compute_statistics(x, pout, result(6), result(7), result(8), result(9));
       }
    }
 
-// Experiment handling
-
 /*!
- * \brief Determine mutual information at input and output of inner and outer decoders
- * \param[out] result   Vector containing the set of results to be updated
+ * \brief Generate and transmit a frame
+ * \param[out] f   Frame, with the sequence at each stage of transmission
  *
- * Results are organized as ...
+ * For the parallel codec case, the received sequence is also demodulated
+ * and inverse mapped, as this does not depend on the priors.
  */
 template <class S>
-void exit_computer<S>::sample(array1d_t& result)
+void exit_computer<S>::createframe(frame_t& f)
    {
-   // Initialise result vector
-   result.init(count());
-
    // Create source stream
-   const array1i_t source = createsource();
+   f.source = createsource();
    // Encode
-   array1i_t encoded;
-   sys->getcodec()->encode(source, encoded);
+   sys->getcodec()->encode(f.source, f.encoded);
    // Map
-   array1i_t mapped;
-   sys->getmapper()->transform(encoded, mapped);
+   sys->getmapper()->transform(f.encoded, f.mapped);
    // Modulate
    array1s_t transmitted;
-   sys->getmodem()->modulate(sys->getmodem()->num_symbols(), mapped,
+   sys->getmodem()->modulate(sys->getmodem()->num_symbols(), f.mapped,
          transmitted);
    // Transmit
-   const array1s_t received = sys->transmit(transmitted);
+   f.received = sys->transmit(transmitted);
+
+   if (exit_type == exit_parallel_codec)
+      {
+      // Demodulate
+      array1vd_t ptable_mapped;
+      sys->getmodem()->demodulate(*sys->getrxchan(), f.received, ptable_mapped);
+      // Inverse Map
+      sys->getmapper()->inverse(ptable_mapped, f.ptable_encoded);
+      }
+   }
+
+/*!
+ * \brief Determine mutual information at input and output of decoder, for
+ *        a given frame and sigma value for the priors
+ * \param[in] s       Communication system to use for decoding
+ * \param[in] r       Random generator for prior probabilities
+ * \param[in] sigma   Sigma value to use when generating binary priors
+ * \param[in] f       Transmitted frame
+ * \param[out] result Vector containing the set of results for this point
+ */
+template <class S>
+void exit_computer<S>::sample_point(commsys<S>& s, libbase::random& r,
+      const double sigma, const frame_t& f, array1d_t& result) const
+   {
+   // Initialise result vector
+   result.init(count_point());
 
    switch(exit_type)
       {
       case exit_parallel_codec:
          {
-         // Demodulate
-         array1vd_t ptable_mapped;
-         sys->getmodem()->demodulate(*sys->getrxchan(), received, ptable_mapped);
-         // Inverse Map
-         array1vd_t ptable_encoded;
-         sys->getmapper()->inverse(ptable_mapped, ptable_encoded);
-
          // Create random priors for message sequence
-         const int N = sys->getcodec()->input_block_size();
-         const int q = sys->getcodec()->num_inputs();
-         array1vd_t priors_source = createpriors(source, N, q);
+         const int N = s.getcodec()->input_block_size();
+         const int q = s.getcodec()->num_inputs();
+         array1vd_t priors_source = createpriors(r, sigma, f.source, N, q);
          // Translate (using given priors)
          codec_softout<libbase::vector>& c = dynamic_cast<codec_softout<
-               libbase::vector>&>(*sys->getcodec());
-         c.init_decoder(ptable_encoded, priors_source);
+               libbase::vector>&>(*s.getcodec());
+         c.init_decoder(f.ptable_encoded, priors_source);
          // Perform soft-output decoding for as many iterations as required
          array1vd_t ri;
          for (int i = 0; i < c.num_iter(); i++)
@@ -260,7 +278,7 @@ void exit_computer<S>::sample(array1d_t& result)
          libbase::normalize_results(ri, ri);
 
          // compute results
-         compute_results(source, priors_source, ri, result);
+         compute_results(f.source, priors_source, ri, result);
          }
          break;
 
@@ -268,12 +286,12 @@ void exit_computer<S>::sample(array1d_t& result)
          {
          // Create random priors for encoded sequence
          // (no need to do actual demodulation and inverse mapping)
-         const int N = sys->getcodec()->output_block_size();
-         const int q = sys->getcodec()->num_outputs();
-         array1vd_t priors_encoded = createpriors(encoded, N, q);
+         const int N = s.getcodec()->output_block_size();
+         const int q = s.getcodec()->num_outputs();
+         array1vd_t priors_encoded = createpriors(r, sigma, f.encoded, N, q);
          // Translate (using given priors)
          codec_softout<libbase::vector>& c = dynamic_cast<codec_softout<
-               libbase::vector>&>(*sys->getcodec());
+               libbase::vector>&>(*s.getcodec());
          c.init_decoder(priors_encoded);
          // Perform soft-output decoding for as many iterations as required
          array1vd_t ri;
@@ -285,21 +303,21 @@ void exit_computer<S>::sample(array1d_t& result)
          libbase::normalize_results(ro, ro);
 
          // compute results
-         compute_results(encoded, priors_encoded, ro, result);
+         compute_results(f.encoded, priors_encoded, ro, result);
          }
          break;
 
       case exit_serial_modem:
          {
          // Create random priors for mapped (demodulated) sequence
-         const int N = sys->getmodem()->input_block_size();
-         const int q = sys->getmodem()->num_symbols();
-         array1vd_t priors_mapped = createpriors(mapped, N, q);
+         const int N = s.getmodem()->input_block_size();
+         const int q = s.getmodem()->num_symbols();
+         array1vd_t priors_mapped = createpriors(r, sigma, f.mapped, N, q);
          // Demodulate
          array1vd_t ptable_mapped;
          informed_modulator<S>& m =
-               dynamic_cast<informed_modulator<S>&> (*sys->getmodem());
-         m.demodulate(*sys->getrxchan(), received, priors_mapped, ptable_mapped);
+               dynamic_cast<informed_modulator<S>&> (*s.getmodem());
+         m.demodulate(*s.getrxchan(), f.received, priors_mapped, ptable_mapped);
          // Compute extrinsic information for passing to codec
          libbase::compute_extrinsic(ptable_mapped, ptable_mapped, priors_mapped);
          libbase::normalize_results(ptable_mapped, ptable_mapped);
@@ -307,10 +325,10 @@ void exit_computer<S>::sample(array1d_t& result)
          // [technically we don't need to do any of the remaining steps]
          // Inverse Map
          array1vd_t ptable_encoded;
-         sys->getmapper()->inverse(ptable_mapped, ptable_encoded);
+         s.getmapper()->inverse(ptable_mapped, ptable_encoded);
          // Translate (using given priors)
          codec_softout<libbase::vector>& c = dynamic_cast<codec_softout<
-               libbase::vector>&>(*sys->getcodec());
+               libbase::vector>&>(*s.getcodec());
          c.init_decoder(ptable_encoded);
          // Perform soft-output decoding for as many iterations as required
          array1vd_t ri;
@@ -319,7 +337,7 @@ void exit_computer<S>::sample(array1d_t& result)
             c.softdecode(ri, ro);
 
          // compute results
-         compute_results(mapped, priors_mapped, ptable_mapped, result);
+         compute_results(f.mapped, priors_mapped, ptable_mapped, result);
          }
          break;
 
@@ -327,15 +345,15 @@ void exit_computer<S>::sample(array1d_t& result)
          {
          // Create random priors for encoded sequence
          // (no need to do actual demodulation)
-         const int N = sys->getmapper()->output_block_size();
-         const int q = sys->getmodem()->num_symbols();
-         array1vd_t priors_mapped = createpriors(mapped, N, q);
+         const int N = s.getmapper()->output_block_size();
+         const int q = s.getmodem()->num_symbols();
+         array1vd_t priors_mapped = createpriors(r, sigma, f.mapped, N, q);
          // Inverse Map
          array1vd_t ptable_encoded;
-         sys->getmapper()->inverse(priors_mapped, ptable_encoded);
+         s.getmapper()->inverse(priors_mapped, ptable_encoded);
          // Translate (using given priors)
          codec_softout<libbase::vector>& c = dynamic_cast<codec_softout<
-               libbase::vector>&>(*sys->getcodec());
+               libbase::vector>&>(*s.getcodec());
          c.init_decoder(ptable_encoded);
          // Perform soft-output decoding for as many iterations as required
          array1vd_t ri_codec;
@@ -344,13 +362,13 @@ void exit_computer<S>::sample(array1d_t& result)
             c.softdecode(ri_codec, ro_codec);
          // Map the soft-output
          array1vd_t ro_modem;
-         sys->getmapper()->transform(ro_codec, ro_modem);
+         s.getmapper()->transform(ro_codec, ro_modem);
          // Compute extrinsic information
          libbase::compute_extrinsic(ro_modem, ro_modem, priors_mapped);
          libbase::normalize_results(ro_modem, ro_modem);
 
          // compute results
-         compute_results(mapped, priors_mapped, ro_modem, result);
+         compute_results(f.mapped, priors_mapped, ro_modem, result);
          }
          break;
 
@@ -360,6 +378,67 @@ void exit_computer<S>::sample(array1d_t& result)
       }
    }
 
+// Experiment handling
+
+/*!
+ * \brief Determine mutual information at input and output of inner and outer decoders
+ * \param[out] result   Vector containing the set of results to be updated
+ *
+ * Results are organized as the set of results for a single point, repeated
+ * for each grid point in grid mode.
+ *
+ * In grid mode, the random generators for the priors at each grid point are
+ * seeded in turn from the main generator, before the grid points are
+ * evaluated in parallel; results therefore do not depend on the number of
+ * threads used.
+ */
+template <class S>
+void exit_computer<S>::sample(array1d_t& result)
+   {
+   // Generate and transmit a frame
+   frame_t f;
+   createframe(f);
+
+   // Single point mode
+   if (grid.size() == 0)
+      {
+      sample_point(*sys, src, sigma, f, result);
+      return;
+      }
+
+   // Initialise result vector
+   const int n = count_point();
+   result.init(grid.size() * n);
+   // Seed random generators for each grid point
+   std::vector<libbase::randgen> r(grid.size());
+   for (int g = 0; g < grid.size(); g++)
+      r[g].seed(src.ival());
+   // Make per-thread copies of system if necessary
+   if (int(sys_copies.size()) != libbase::getthreadcount())
+      init_copies();
+   // Evaluate grid points in parallel
+#pragma omp parallel for schedule(dynamic)
+   for (int g = 0; g < grid.size(); g++)
+      {
+      array1d_t result_point;
+      sample_point(*sys_copies[libbase::getthreadid()], r[g], grid(g), f,
+            result_point);
+      result.segment(g * n, n) = result_point;
+      }
+   }
+
+template <class S>
+std::string exit_computer<S>::result_description(int i) const
+   {
+   assert(i >= 0 && i < count());
+   if (grid.size() == 0)
+      return result_description_point(i);
+   const int n = count_point();
+   std::ostringstream sout;
+   sout << result_description_point(i % n) << "[𝜎=" << grid(i / n) << "]";
+   return sout.str();
+   }
+
 // Description & Serialization
 
 template <class S>
@@ -394,6 +473,9 @@ std::string exit_computer<S>::description() const
    const double p = sys->gettxchan()->get_parameter();
    assert(p == sys->getrxchan()->get_parameter());
    sout << ", system parameter = " << p;
+   // grid mode
+   if (grid.size() > 0)
+      sout << ", " << grid.size() << "-point grid";
    return sout.str();
    }
 
@@ -404,11 +486,13 @@ std::ostream& exit_computer<S>::serialize(std::ostream& sout) const
    {
    // format version
    sout << "# Version" << std::endl;
-   sout << 2 << std::endl;
+   sout << 3 << std::endl;
    sout << "# EXIT chart type (0=parallel/codec, 1=serial/codec, 2=serial/modem, 3=serial/codec+mapper)" << std::endl;
    sout << exit_type << std::endl;
    sout << "# Compute binary LLR statistics?" << std::endl;
    sout << compute_llr_statistics << std::endl;
+   sout << "# Grid of sigma values for priors (count, then values; 0 for single point)" << std::endl;
+   sout << grid;
    // system parameter
    const double p = sys->gettxchan()->get_parameter();
    assert(p == sys->getrxchan()->get_parameter());
@@ -425,6 +509,8 @@ std::ostream& exit_computer<S>::serialize(std::ostream& sout) const
  * \version 1 Initial version
  *
  * \version 2 Added flag for computing binary LLR statistics
+ *
+ * \version 3 Added grid of sigma values for priors
  */
 
 template <class S>
@@ -443,6 +529,11 @@ std::istream& exit_computer<S>::serialize(std::istream& sin)
       sin >> libbase::eatcomments >> compute_llr_statistics >> libbase::verify;
    else
       compute_llr_statistics = true;
+   // get grid of sigma values for priors
+   if (version >= 3)
+      sin >> libbase::eatcomments >> grid >> libbase::verify;
+   else
+      grid.init(0);
    // get system parameter
    double p;
    sin >> libbase::eatcomments >> p >> libbase::verify;
@@ -451,6 +542,7 @@ std::istream& exit_computer<S>::serialize(std::istream& sin)
    // setup
    sys->gettxchan()->set_parameter(p);
    sys->getrxchan()->set_parameter(p);
+   sys_copies.clear();
    return sin;
    }
 
@@ -27,6 +27,7 @@
 #include "commsys.h"
 #include "randgen.h"
 #include "serializer.h"
+#include <vector>
 
 namespace libcomm {
 
@@ -47,6 +48,15 @@ namespace libcomm {
  * decoder are computed and returned as results. The process is repeated with
  * the decoders swapped.
  *
+ * In grid mode, a whole set of sigma values for the priors is given as part
+ * of this object, and the parameter passed by the simulator is the system's
+ * channel parameter instead. Each frame is generated and transmitted once,
+ * and shared by all grid points; the grid points are then evaluated in
+ * parallel, each with its own copy of the system and its own random
+ * generator for the priors. Results are given for each grid point in turn,
+ * so that a complete EXIT curve for a given channel is obtained in a single
+ * simulation run.
+ *
  * \todo Add serialization setting to indicate what type of results to compute
  * (e.g. straight mutual information, sigma/mu of binary representation, etc)
  */
@@ -59,6 +69,14 @@ public:
    typedef libbase::vector<S> array1s_t;
    typedef libbase::vector<double> array1d_t;
    typedef libbase::vector<array1d_t> array1vd_t;
+   //! Transmitted frame, shared by all grid points
+   struct frame_t {
+      array1i_t source; //!< Source sequence
+      array1i_t encoded; //!< Encoded sequence
+      array1i_t mapped; //!< Mapped sequence
+      array1s_t received; //!< Received sequence
+      array1vd_t ptable_encoded; //!< Inverse-mapped channel information (parallel codec only)
+   };
    enum exit_t {
       exit_parallel_codec = 0, //!< parallel concatenated code, codec object
       exit_serial_codec, //!< serial concatenated code, codec object
@@ -74,20 +92,42 @@ protected:
    exit_t exit_type; //!< enum indicating type of EXIT curve to plot
    bool compute_llr_statistics; //!< switch for computing binary LLR statistics
    double sigma; //!< Sigma value to use when generating binary priors
+   array1d_t grid; //!< Sigma values for grid mode (empty for single point)
    // @}
    /*! \name Internally-used objects */
    libbase::randgen src; //!< Random generator for source data sequence and prior probabilities
+   std::vector<boost::shared_ptr<commsys<S> > > sys_copies; //!< Copies of system for grid points, one per thread
    // @}
 protected:
    /*! \name Internal functions */
    array1i_t createsource();
-   array1vd_t createpriors(const array1i_t& tx, const int N, const int q);
+   static array1vd_t createpriors(libbase::random& r, const double sigma,
+         const array1i_t& tx, const int N, const int q);
    static double compute_mutual_information(const array1i_t& x,
          const array1vd_t& y);
    static void compute_statistics(const array1i_t& x, const array1vd_t& p,
-         const int value, double& sigma, double& mu);
+         double& sigma0, double& mu0, double& sigma1, double& mu1);
    void compute_results(const array1i_t& x, const array1vd_t& pin,
          const array1vd_t& pout, array1d_t& result) const;
+   void createframe(frame_t& f);
+   void sample_point(commsys<S>& s, libbase::random& r, const double sigma,
+         const frame_t& f, array1d_t& result) const;
+   //! Number of results for each grid point
+   int count_point() const
+      {
+      int result = 2; // default: mutual information at input+output
+      if (compute_llr_statistics)
+         result += 8; // sigma+mu for each of 0+1 at input+output
+      return result;
+      }
+   //! Make per-thread copies of system for grid points
+   void init_copies()
+      {
+      sys_copies.resize(libbase::getthreadcount());
+      for (size_t t = 0; t < sys_copies.size(); t++)
+         sys_copies[t] = boost::dynamic_pointer_cast<commsys<S> >(
+               sys->clone());
+      }
    // @}
 public:
    /*! \name Constructors / Destructors */
@@ -97,8 +137,10 @@ public:
     * Initializes system with bound objects cloned from supplied system.
     */
    exit_computer(const exit_computer<S>& c) :
-         sys(boost::dynamic_pointer_cast<commsys<S> >(c.sys->clone())), src(
-               c.src)
+         sys(boost::dynamic_pointer_cast<commsys<S> >(c.sys->clone())),
+               exit_type(c.exit_type),
+               compute_llr_statistics(c.compute_llr_statistics),
+               sigma(c.sigma), grid(c.grid), src(c.src)
       {
       }
    exit_computer()
@@ -114,14 +156,24 @@ public:
       {
       src.seed(r.ival());
       sys->seedfrom(r);
+      sys_copies.clear();
       }
    void set_parameter(const double x)
       {
       assertalways(x >= 0);
-      sigma = x;
+      if (grid.size() > 0)
+         {
+         sys->gettxchan()->set_parameter(x);
+         sys->getrxchan()->set_parameter(x);
+         sys_copies.clear();
+         }
+      else
+         sigma = x;
       }
    double get_parameter() const
       {
+      if (grid.size() > 0)
+         return sys->gettxchan()->get_parameter();
       return sigma;
       }
 
@@ -129,18 +181,19 @@ public:
    void sample(array1d_t& result);
    int count() const
       {
-      int result = 2; // default: mutual information at input+output
-      if (compute_llr_statistics)
-         result += 8; // sigma+mu for each of 0+1 at input+output
-      return result;
+      if (grid.size() > 0)
+         return grid.size() * count_point();
+      return count_point();
       }
    int get_multiplicity(int i) const
       {
       return 1;
       }
-   std::string result_description(int i) const
+   std::string result_description(int i) const;
+   //! Description of result 'i' for a single grid point
+   std::string result_description_point(int i) const
       {
-      assert(i >= 0 && i < count());
+      assert(i >= 0 && i < count_point());
       switch (i)
          {
          case 0:
@@ -20,6 +20,7 @@
  */
 
 #include "named_lut.h"
+#include "tablecache.h"
 #include <sstream>
 
 namespace libcomm {
@@ -56,7 +57,8 @@ std::istream& named_lut<real>::serialize(std::istream& sin)
    {
    sin >> libbase::eatcomments >> m >> libbase::verify;
    sin >> libbase::eatcomments >> lutname >> libbase::verify;
-   sin >> libbase::eatcomments >> this->lut >> libbase::verify;
+   // the table itself may be large, so read it through the cache
+   libbase::tablecache::read(sin, this->lut);
    return sin;
    }
 
@@ -105,8 +105,8 @@ public:
       // 'tx' is the vector of transmitted symbols that we're considering
       const array1s_t& tx = encoding_table(i, d);
       // set up space for results
-      static array1r2_t ptable_r;
-      ptable_r.init(ptable.size());
+      // NOTE: this is local as we may be called from parallel threads
+      array1r2_t ptable_r(ptable.size());
       // call batch receiver method
       computer->receive(tx, r, ptable_r);
       // apply priors at codeword level if applicable
@@ -26,6 +26,7 @@
 #include "cputimer.h"
 #include "pacifier.h"
 #include "vectorutils.h"
+#include "tablecache.h"
 #include <sstream>
 
 namespace libcomm {
@@ -41,6 +42,26 @@ namespace libcomm {
 #  define DEBUG 1
 #endif
 
+namespace {
+
+/*! \brief Maximum number of characters in the text form of a symbol
+ * Field elements are read as binary digits, which need not be separated by
+ * whitespace; zero indicates that symbols are whitespace-delimited.
+ */
+template <class sig>
+int token_width()
+   {
+   return sig::dimension();
+   }
+
+template <>
+int token_width<bool> ()
+   {
+   return 0;
+   }
+
+} // end unnamed namespace
+
 /*! \brief Determines and returns codebook to be used at index 'i'.
  * \return Index for codebook to use (into the codebook tables)
  *
@@ -426,35 +447,46 @@ void tvb<sig, real, real2>::init(const channel<sig>& chan,
    checkforchanges(m1_min, m1_max, mn_min, mn_max, mtau_min, mtau_max);
    //! Determine whether to use global storage
    static bool globalstore = false; // set to avoid compiler warning
+   static bool checkpoint = false;
    bool last_globalstore = globalstore; // keep track of last setting
+   bool last_checkpoint = checkpoint;
    const int required = fba_type::get_memory_required(N, q, mtau_min, mtau_max,
          mn_min, mn_max);
    switch (storage_type)
       {
       case storage_local:
          globalstore = false;
+         checkpoint = false;
          break;
 
       case storage_global:
          globalstore = true;
+         checkpoint = false;
          break;
 
       case storage_conditional:
          globalstore = (required <= globalstore_limit);
+         checkpoint = false;
          checkforchanges(globalstore, required);
          break;
 
+      case storage_checkpoint:
+         globalstore = true;
+         checkpoint = true;
+         break;
+
       default:
          failwith("Unknown storage mode");
          break;
       }
    // Create an embedded algorithm object of the correct type, as needed
-   if (!fba_ptr || globalstore != last_globalstore)
+   if (!fba_ptr || globalstore != last_globalstore
+         || checkpoint != last_checkpoint)
       {
       const bool fss = mychan->is_statespace_fixed();
       const bool thresholding = th_inner > real(0) || th_outer > real(0);
       fba_ptr = fba2_factory<sig, real, real2>::get_instance(fss, thresholding,
-            flags.lazy, globalstore);
+            flags.lazy, globalstore, checkpoint);
       // Mark the encoding table as changed, to force receiver init
       changed_encoding_table = true;
       }
@@ -784,6 +816,10 @@ std::string tvb<sig, real, real2>::description() const
          sout << ", global storage [≤" << globalstore_limit << " MiB]";
          break;
 
+      case storage_checkpoint:
+         sout << ", checkpointed global storage";
+         break;
+
       default:
          failwith("Unknown storage mode");
          break;
@@ -815,7 +851,7 @@ std::ostream& tvb<sig, real, real2>::serialize(std::ostream& sout) const
    sout << Pr << std::endl;
    sout << "# Lazy computation of gamma?" << std::endl;
    sout << flags.lazy << std::endl;
-   sout << "# Storage mode for gamma (0=local, 1=global, 2=conditional)" << std::endl;
+   sout << "# Storage mode for gamma (0=local, 1=global, 2=conditional, 3=checkpointed)" << std::endl;
    sout << storage_type << std::endl;
    if (storage_type == storage_conditional)
       {
@@ -1024,14 +1060,29 @@ std::istream& tvb<sig, real, real2>::serialize(std::istream& sin)
             // read codeword length
             if (version >= 11)
                sin >> libbase::eatcomments >> n >> libbase::verify;
-            // read codebook from stream
+            // read codebook from stream, or from the cache
             array1vs_t codebook_s;
             libbase::allocate(codebook_s, q, n);
             sin >> libbase::eatcomments;
-            for (int d = 0; d < q; d++)
+            std::vector<int> table;
+            if (libbase::tablecache::lookup(q * n, table))
                {
-               codebook_s(d).serialize(sin);
+               libbase::tablecache::skip(sin, q * n, token_width<sig> ());
                libbase::verify(sin);
+               for (int d = 0, k = 0; d < q; d++)
+                  for (int s = 0; s < n; s++)
+                     codebook_s(d)(s) = sig(table[k++]);
+               }
+            else
+               {
+               for (int d = 0; d < q; d++)
+                  {
+                  codebook_s(d).serialize(sin);
+                  libbase::verify(sin);
+                  for (int s = 0; s < n; s++)
+                     table.push_back(codebook_s(d)(s));
+                  }
+               libbase::tablecache::store(table);
                }
             // copy read codebook
             copycodebook(i, codebook_s);
@@ -87,6 +87,7 @@ public:
       storage_local = 0, //!< always use local storage
       storage_global, //!< always use global storage
       storage_conditional, //!< use global storage below memory limit
+      storage_checkpoint, //!< use global storage with checkpointed segments
       storage_undefined
    };
    // @}
@@ -25,6 +25,8 @@
 #include "fsm.h"
 #include "itfunc.h"
 #include "randgen.h"
+#include "packedvector.h"
+#include "tablecache.h"
 #include <sstream>
 #include <limits>
 
@@ -34,18 +36,41 @@ using libbase::vector;
 
 // worker processes
 
+/*!
+ * \brief Receive and set up the system to simulate
+ *
+ * The system digest is computed first; if this matches the system already
+ * set up (as when the master moves on to the next parameter), the existing
+ * system is kept. Otherwise the system is created from its serialization,
+ * with large tables read through the node-local table cache keyed on the
+ * digest.
+ */
 void montecarlo::slave_getcode(void)
    {
-   system.reset();
    // Receive system as a string
    std::string systemstring;
    cluster.receive(systemstring);
-   // Create system object from serialization
-   std::istringstream is(systemstring);
-   is >> system;
    // Compute its digest
+   std::istringstream is(systemstring);
+   sha digest;
+   digest.process(is);
+   if (system && digest == sysdigest)
+      {
+      std::cerr << "Date: " << libbase::timer::date() << std::endl;
+      std::cerr << "Keeping system with digest: " << std::string(sysdigest)
+            << std::endl;
+      return;
+      }
+   system.reset();
+   sysdigest = digest;
+   // Create system object from serialization
+   is.clear();
    is.seekg(0);
-   sysdigest.process(is);
+      {
+      const std::string key = sysdigest;
+      libbase::tablecache::context cache(key);
+      is >> system;
+      }
    // Tell the user what we've done
    std::cerr << "Date: " << libbase::timer::date() << std::endl;
    std::cerr << system->description() << std::endl;
@@ -172,8 +197,9 @@ void montecarlo::writestate(std::ostream& sout) const
    sout << "## System: " << sysdigest << std::endl;
    sout << "## Parameter: " << system->get_parameter() << std::endl;
    sout << "## Samples: " << get_samplecount() << std::endl;
-   sout << "## State: " << state.size() << '\t';
-   state.serialize(sout, '\t');
+   const std::string packed = libbase::pack(state);
+   sout << "## Packed: " << packed.size() << std::endl;
+   sout.write(packed.data(), packed.size());
    sout << std::flush;
    libbase::trace << "DEBUG (montecarlo): position after = " << sout.tellp()
          << std::endl;
@@ -205,6 +231,15 @@ void montecarlo::lookforstate(std::istream& sin)
          std::istringstream is(s.substr(9));
          is >> state;
          }
+      else if (s.substr(0, 10) == "## Packed:")
+         {
+         size_t length = 0;
+         std::istringstream(s.substr(10)) >> length;
+         std::string packed(length, '\0');
+         if (length > 0)
+            sin.read(&packed[0], length);
+         libbase::unpack(packed, state);
+         }
       }
    // reset file
    sin.clear();
@@ -217,6 +252,16 @@ void montecarlo::lookforstate(std::istream& sin)
       }
    }
 
+/*!
+ * \brief Key for saved states, made up of the system digest and parameter
+ */
+std::string montecarlo::statekey() const
+   {
+   std::ostringstream sout;
+   sout << sysdigest << ':' << system->get_parameter();
+   return sout.str();
+   }
+
 // overrideable user-interface functions
 
 /*!
@@ -98,6 +98,7 @@ protected:
          libbase::vector<double>& errormargin) const;
    void writestate(std::ostream& sout) const;
    void lookforstate(std::istream& sin);
+   std::string statekey() const;
    /*! \name Overrideable user-interface functions */
    /*! \brief User-interrupt check
     * This function should return true if the user has requested an interrupt.
@@ -20,8 +20,11 @@
  */
 
 #include "resultsfile.h"
+#include "sha.h"
 
 #include <fstream>
+#include <sstream>
+#include <cstdio>
 
 #ifdef _WIN32
 #  include <io.h>
@@ -30,6 +33,7 @@
 #else
 #  include <unistd.h>
 #  include <sys/types.h>
+#  include <sys/stat.h>
 #endif
 
 namespace libcomm {
@@ -38,6 +42,26 @@ using libbase::vector;
 
 // Results file helper functions
 
+/*! \brief Get the size and modification time of the named file
+ * \return False if the file could not be accessed
+ */
+bool resultsfile::getfilestamp(const std::string& name, std::streamoff& size,
+      std::time_t& mtime)
+   {
+#ifdef _WIN32
+   struct _stat s;
+   if (_stat(name.c_str(), &s) != 0)
+      return false;
+#else
+   struct stat s;
+   if (stat(name.c_str(), &s) != 0)
+      return false;
+#endif
+   size = s.st_size;
+   mtime = s.st_mtime;
+   return true;
+   }
+
 /*! \brief If this is the first time, write the header
  * \note This method also updates the write position so that the header is not
  * overwritten on the next write.
@@ -54,44 +78,46 @@ void resultsfile::writeheaderifneeded(std::fstream& file)
       }
    }
 
-/*! \brief Close and truncate the file, and update digest
- * Truncation is needed to remove any detritus from previously-saved states.
+/*! \brief Close and truncate the file, and update size and time stamp
+ * Truncation is needed to remove any detritus from previously-written
+ * interim results.
  */
 void resultsfile::finishwithfile(std::fstream& file)
    {
    std::streampos length = file.tellp();
    // close and truncate file
    file.close();
-   truncate(length);
-   // re-open and update digest
-   file.open(fname.c_str(), std::ios::in);
-   filedigest.process(file);
+   truncate(fname, length);
+   // keep track of file as we left it
+   getfilestamp(fname, filesize, filetime);
    }
 
-void resultsfile::truncate(std::streampos length)
+void resultsfile::truncate(const std::string& name, std::streampos length)
    {
-   assert(!fname.empty());
+   assert(!name.empty());
 #ifdef _WIN32
    int fd;
-   _sopen_s(&fd, fname.c_str(), _O_RDWR, _SH_DENYNO, _S_IREAD | _S_IWRITE);
+   _sopen_s(&fd, name.c_str(), _O_RDWR, _SH_DENYNO, _S_IREAD | _S_IWRITE);
    _chsize_s(fd, length);
    _close(fd);
 #else
-   assertalways(::truncate(fname.c_str(), length)==0);
+   assertalways(::truncate(name.c_str(), length)==0);
 #endif
    }
 
+/*! \brief Set the write position, depending on whether the file was modified
+ * The file is considered modified if its size or modification time differ
+ * from those after our last write; this avoids having to read the file.
+ */
 void resultsfile::checkformodifications(std::fstream& file)
    {
    assert(file.good());
    libbase::trace << "DEBUG (resultsfile): checking file for modifications." << std::endl;
    // check for user modifications
-   sha curdigest;
-   file.seekg(0);
-   curdigest.process(file);
-   // reset file
-   file.clear();
-   if (curdigest == filedigest)
+   std::streamoff cursize = -1;
+   std::time_t curtime = 0;
+   getfilestamp(fname, cursize, curtime);
+   if (cursize == filesize && curtime == filetime)
       file.seekp(fileptr);
    else
       {
@@ -102,6 +128,196 @@ void resultsfile::checkformodifications(std::fstream& file)
       }
    }
 
+// State journal helper functions
+
+//! Checksum of a journal record payload
+std::string resultsfile::checksum(const std::string& payload)
+   {
+   sha digest;
+   std::istringstream sin(payload);
+   digest.process(sin);
+   return std::string(digest);
+   }
+
+/*! \brief Index the last record for each key in the journal
+ * Only record headers are read; payloads are skipped over. Scanning stops
+ * at the first incomplete or malformed record.
+ * \return The position just after the last complete record
+ */
+std::streamoff resultsfile::scanjournal(std::istream& sin, journalindex& index)
+   {
+   sin.seekg(0, std::ios_base::end);
+   const std::streamoff size = sin.tellg();
+   std::streamoff end = 0;
+   sin.seekg(0);
+   while (end < size)
+      {
+      journalrecord record;
+      record.header = end;
+      std::string tag, key;
+      sin >> tag >> key >> record.length >> record.sum;
+      if (sin.fail() || tag != "@@" || sin.get() != '\n')
+         break;
+      record.offset = sin.tellg();
+      if (record.length < 0 || record.offset + record.length > size)
+         break;
+      index[key] = record;
+      end = record.offset + record.length;
+      sin.seekg(end);
+      }
+   sin.clear();
+   return end;
+   }
+
+/*! \brief Read the payload of a journal record
+ * \return False if the payload could not be read or fails its checksum
+ */
+bool resultsfile::readrecord(std::istream& sin, const journalrecord& record,
+      std::string& payload)
+   {
+   payload.assign(size_t(record.length), '\0');
+   if (record.length > 0)
+      {
+      sin.clear();
+      sin.seekg(record.offset);
+      sin.read(&payload[0], record.length);
+      if (std::streamoff(sin.gcount()) != record.length)
+         return false;
+      }
+   return checksum(payload) == record.sum;
+   }
+
+/*! \brief Look for a saved state for the current key in the journal
+ * Any partly-written record at the end of the journal is discarded.
+ * \return True if the journal has a record for the current key (which
+ * supersedes any state kept in the results file itself)
+ */
+bool resultsfile::lookforjournalstate()
+   {
+   journalsize = 0;
+   journallive = 0;
+   std::ifstream file(journalname().c_str(), std::ios::in | std::ios::binary);
+   if (!file)
+      return false;
+   journalindex index;
+   journalsize = scanjournal(file, index);
+   // keep track of space taken by current records for other keys
+   const std::string key = statekey();
+   for (journalindex::const_iterator it = index.begin(); it != index.end(); it++)
+      if (it->first != key && it->second.length > 0)
+         journallive += it->second.offset + it->second.length
+               - it->second.header;
+   // load state for the current key
+   journalindex::const_iterator it = index.find(key);
+   if (it != index.end())
+      {
+      std::string payload;
+      if (!readrecord(file, it->second, payload))
+         std::cerr << "NOTICE: saved state is corrupt - ignoring." << std::endl;
+      else if (!payload.empty())
+         {
+         std::istringstream sin(payload);
+         lookforstate(sin);
+         }
+      }
+   file.close();
+   // discard any partly-written record
+   std::streamoff size;
+   std::time_t mtime;
+   if (getfilestamp(journalname(), size, mtime) && size > journalsize)
+      {
+      std::cerr << "NOTICE: incomplete state record found - discarding."
+            << std::endl;
+      truncate(journalname(), journalsize);
+      }
+   return it != index.end();
+   }
+
+/*! \brief Append a record with the current state to the journal
+ * An empty state marks any earlier state for the current key as obsolete.
+ * When the journal grows large compared to the records still needed, it is
+ * rewritten with just those records; this is done in a separate file which
+ * then replaces the journal, so that a consistent journal always exists.
+ */
+void resultsfile::appendstate()
+   {
+   std::ostringstream sout;
+   writestate(sout);
+   const std::string payload = sout.str();
+   const std::string key = statekey();
+   std::ostringstream rout;
+   rout << "@@ " << key << ' ' << payload.size() << ' ' << checksum(payload)
+         << '\n' << payload;
+   const std::string record = rout.str();
+   const std::streamoff rsize = record.size();
+   if (journalsize + rsize <= 4 * (journallive + rsize))
+      {
+      std::ofstream file(journalname().c_str(), std::ios::out | std::ios::app
+            | std::ios::binary);
+      file << record;
+      file.close();
+      assertalways(file.good());
+      journalsize += rsize;
+      return;
+      }
+   libbase::trace << "DEBUG (resultsfile): compacting state journal." << std::endl;
+   const std::string tmpname = journalname() + ".tmp";
+      {
+      std::ifstream sin(journalname().c_str(), std::ios::in | std::ios::binary);
+      journalindex index;
+      scanjournal(sin, index);
+      std::ofstream file(tmpname.c_str(), std::ios::out | std::ios::trunc
+            | std::ios::binary);
+      journallive = 0;
+      for (journalindex::const_iterator it = index.begin(); it != index.end(); it++)
+         {
+         std::string p;
+         if (it->first == key || it->second.length == 0 || !readrecord(sin,
+               it->second, p))
+            continue;
+         const std::streamoff start = file.tellp();
+         file << "@@ " << it->first << ' ' << p.size() << ' ' << it->second.sum
+               << '\n' << p;
+         journallive += std::streamoff(file.tellp()) - start;
+         }
+      file << record;
+      journalsize = file.tellp();
+      file.close();
+      assertalways(file.good());
+      }
+#ifdef _WIN32
+   // rename does not replace an existing file on Windows
+   std::remove(journalname().c_str());
+#endif
+   assertalways(std::rename(tmpname.c_str(), journalname().c_str()) == 0);
+   }
+
+/*! \brief Mark the state for the current key as obsolete
+ * If the journal holds nothing else, it is simply removed.
+ */
+void resultsfile::clearstate()
+   {
+   if (journalsize == 0)
+      return;
+   if (journallive > 0)
+      {
+      std::ostringstream rout;
+      rout << "@@ " << statekey() << ' ' << 0 << ' ' << checksum("") << '\n';
+      const std::string record = rout.str();
+      std::ofstream file(journalname().c_str(), std::ios::out | std::ios::app
+            | std::ios::binary);
+      file << record;
+      file.close();
+      assertalways(file.good());
+      journalsize += record.size();
+      }
+   else
+      {
+      std::remove(journalname().c_str());
+      journalsize = 0;
+      }
+   }
+
 // File handling interface
 
 void resultsfile::init(const std::string& fname)
@@ -116,8 +332,10 @@ void resultsfile::init(const std::string& fname)
 
 /*! \brief Set up the results file and look for a state
  * If the file does not exist, a new one is created. Otherwise, the write
- * point is set to the end of file and a digest of the current file contents
- * is kept. A search for a saved state is also initiated by this method.
+ * point is set to the end of file and its size and modification time are
+ * kept. A search for a saved state is also initiated by this method, first
+ * in the state journal and then (for files written by earlier versions) in
+ * the results file itself.
  *
  * \note The current simulation must be already set up at this point, so that
  * a valid comparison can be made.
@@ -140,13 +358,14 @@ void resultsfile::setupfile()
       }
    assertalways(file.good());
    // look for saved-state
-   lookforstate(file);
+   if (!lookforjournalstate())
+      lookforstate(file);
    // set write position at end
    file.seekp(0, std::ios_base::end);
    fileptr = file.tellp();
-   // update digest
-   file.seekg(0);
-   filedigest.process(file);
+   file.close();
+   // keep track of file as we left it
+   getfilestamp(fname, filesize, filetime);
    // start timer for interim results writing
    t.start();
    // update flags
@@ -159,7 +378,7 @@ void resultsfile::setupfile()
  * than 30 seconds (this quantity is hard-wired).
  *
  * \note This method does not change the write position so that this result is
- * overwritten on the next write.
+ * overwritten on the next write. The state is appended to the journal.
  */
 void resultsfile::writeinterimresults(libbase::vector<double>& result,
       libbase::vector<double>& errormargin)
@@ -175,8 +394,8 @@ void resultsfile::writeinterimresults(libbase::vector<double>& result,
    checkformodifications(file);
    writeheaderifneeded(file);
    writeresults(file, result, errormargin);
-   writestate(file);
    finishwithfile(file);
+   appendstate();
    // restart timer
    t.start();
    }
@@ -185,7 +404,7 @@ void resultsfile::writeinterimresults(libbase::vector<double>& result,
  * This method is called when the final result is reached. A file write is
  * guaranteed to occur. The write-limiting timer is also stopped to avoid
  * lapsing on object destruction. If requested, the final state is also
- * written.
+ * written; otherwise any saved state for this simulation is marked obsolete.
  *
  * \note This method also updates the write position so that this result is not
  * overwritten.
@@ -201,11 +420,13 @@ void resultsfile::writefinalresults(libbase::vector<double>& result,
    checkformodifications(file);
    writeheaderifneeded(file);
    writeresults(file, result, errormargin);
-   if (savestate)
-      writestate(file);
    // update write-position
    fileptr = file.tellp();
    finishwithfile(file);
+   if (savestate)
+      appendstate();
+   else
+      clearstate();
    // stop timer and clear setup flag (in preparation for next simulation run)
    t.stop();
    filesetup = false;
@@ -24,9 +24,12 @@
 
 #include "config.h"
 
+#include "vector.h"
 #include "walltimer.h"
-#include "sha.h"
 #include <iostream>
+#include <string>
+#include <map>
+#include <ctime>
 
 namespace libcomm {
 
@@ -38,17 +41,28 @@ namespace libcomm {
  * and closes the file for every write, ensuring that written results are
  * flushed, and also allowing the user to manipulate the file between writes.
  *
- * The handler keeps track of the file digest between writes, checking for
- * any external changes. In such cases, the file is considered 'modified'
- * and the next write happens at the end of the file.
+ * The handler keeps track of the file size and modification time between
+ * writes, checking for any external changes. In such cases, the file is
+ * considered 'modified' and the next write happens at the end of the file.
  *
  * The handler also allows 'interim' result writing. In this case, the result
  * is written together with the simulation state. This allows the user to
  * continue an aborted simulation (due to simulator or machine crash, for
- * example). When a file is initialized, a search for the last-save simulator
+ * example). When a file is initialized, a search for the last-saved simulator
  * state is performed. If this matches the current system at the current
  * parameter, this state needs to be loaded.
  *
+ * States are kept in a journal alongside the results file (with the same
+ * name and a '.state' suffix), so that the results file itself only holds
+ * the header and result lines. Each state is appended as a record holding
+ * a key for the simulation point, the state size, and a checksum, so that
+ * a partly-written record (eg after a crash) is recognized and skipped.
+ * On set-up, only the record headers are read to find the last record for
+ * the current key. The journal is compacted when superseded records grow
+ * large compared to the latest one, and removed once the final result is
+ * written without a state. For compatibility, if no journal record is
+ * found, the results file is searched for a state as in earlier versions.
+ *
  * \note The handler does not specify the format for writing any of the
  * header, result lines, or state. Instead, these functions are performed
  * by virtual methods.
@@ -75,16 +89,42 @@ private:
    bool filesetup; //!< Flag to indicate that the results file was set up
    bool headerwritten; //!< Flag to indicate that the results header has been written
    std::streampos fileptr; //!< Position in file where we should write the next result
-   sha filedigest; //!< Digest of file as at last update
+   std::streamoff filesize; //!< Size of file as at last update
+   std::time_t filetime; //!< Modification time of file as at last update
+   std::streamoff journalsize; //!< Size of state journal
+   std::streamoff journallive; //!< Size of current records for other keys in journal
    libbase::walltimer t; //!< Timer to keep track of running estimate
    // @}
 private:
    /*! \name Results file helper functions */
+   static bool getfilestamp(const std::string& name, std::streamoff& size,
+         std::time_t& mtime);
    void writeheaderifneeded(std::fstream& file);
    void finishwithfile(std::fstream& file);
-   void truncate(std::streampos length);
+   static void truncate(const std::string& name, std::streampos length);
    void checkformodifications(std::fstream& file);
    // @}
+   /*! \name State journal helper functions */
+   //! Location of a record in the state journal
+   struct journalrecord {
+      std::streamoff header; //!< Start of record
+      std::streamoff offset; //!< Start of payload
+      std::streamoff length; //!< Size of payload
+      std::string sum; //!< Checksum of payload
+   };
+   typedef std::map<std::string, journalrecord> journalindex;
+   static std::string checksum(const std::string& payload);
+   static std::streamoff scanjournal(std::istream& sin, journalindex& index);
+   static bool readrecord(std::istream& sin, const journalrecord& record,
+         std::string& payload);
+   std::string journalname() const
+      {
+      return fname + ".state";
+      }
+   bool lookforjournalstate();
+   void appendstate();
+   void clearstate();
+   // @}
 protected:
    /*! \name System-specific functions */
    virtual void writeheader(std::ostream& sout) const = 0;
@@ -93,12 +133,18 @@ protected:
          libbase::vector<double>& errormargin) const = 0;
    virtual void writestate(std::ostream& sout) const = 0;
    virtual void lookforstate(std::istream& sin) = 0;
+   /*! \brief Key identifying the current simulation point
+    * Saved states are only considered for loading if their key matches. The
+    * key may not contain whitespace.
+    */
+   virtual std::string statekey() const = 0;
    // @}
 public:
    /*! \name Constructor/destructor */
    // Constructor/destructor
    resultsfile() :
-      filesetup(false), headerwritten(false), t("resultsfile", false)
+      filesetup(false), headerwritten(false), filesize(0), filetime(0),
+            journalsize(0), journallive(0), t("resultsfile", false)
       {
       }
    virtual ~resultsfile()
@@ -200,7 +200,9 @@ void stegosystem::DemodulateData(const vector<sigspace>& s, vector<int>& d)
    // BPSK blockmodem
    mpsk mdm(2);
    // demodulate signal
-   for (int i = 0; i < s.size(); i++)
+   const int N = s.size();
+#pragma omp parallel for
+   for (int i = 0; i < N; i++)
       d(i) = mdm.demodulate(s(i));
    }
 
@@ -309,10 +311,14 @@ void stegosystem::DemodulateEmbedSequence(const vector<double>& v,
    assert(u.size() == v.size());
    s.init(u.size());
    mpsk mdm(2);
-   for (int i = 0; i < u.size(); i++)
+   const sigspace s0 = mdm[0];
+   const sigspace ds = mdm[1] - mdm[0];
+   const int N = u.size();
+#pragma omp parallel for
+   for (int i = 0; i < N; i++)
       {
       const double d = (v(i) - u(i)) / (plmod(u(i)) - u(i));
-      s(i) = mdm[0] + d * (mdm[1] - mdm[0]);
+      s(i) = s0 + d * ds;
       }
    }
 
@@ -330,10 +336,13 @@ void stegosystem::ConvertToUniform(const vector<double>& g, vector<double>& v)
    {
    assert(g.size() > 0);
    v.init(g.size());
-   for (int i = 0; i < g.size(); i++)
+   const int N = g.size();
+#pragma omp parallel for
+   for (int i = 0; i < N; i++)
       {
-      if ((i & 0xff) == 0)
-         DisplayProgress(i, g.size(), 2, (!m_pCodec) ? 3 : 5);
+      // progress is only shown from the calling thread
+      if ((i & 0xff) == 0 && libbase::getthreadid() == 0)
+         DisplayProgress(i, N, 2, (!m_pCodec) ? 3 : 5);
       v(i) = (boost::math::erf(g(i) / sqrt(double(2))) + 1.0) / 2.0;
       }
    }
@@ -342,10 +351,13 @@ void stegosystem::ConvertToGaussian(const vector<double>& v, vector<double>& g)
    {
    assert(v.size() > 0);
    g.init(v.size());
-   for (int i = 0; i < v.size(); i++)
+   const int N = v.size();
+#pragma omp parallel for
+   for (int i = 0; i < N; i++)
       {
-      if ((i & 0xff) == 0)
-         DisplayProgress(i, v.size(), 1, 4);
+      // progress is only shown from the calling thread
+      if ((i & 0xff) == 0 && libbase::getthreadid() == 0)
+         DisplayProgress(i, N, 1, 4);
       g(i) = boost::math::erf_inv(2 * v(i) - 1) * sqrt(double(2));
       }
    }
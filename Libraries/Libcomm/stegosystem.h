@@ -82,6 +82,12 @@ namespace libcomm {
  * - changed name from CStegoSystem to stegosystem, to better reflect library usage.
  * - although not according to library practice, the function names have been left as
  * they are (camel case).
+ *
+ * \version 1.30
+ * - per-element loops in demodulation and in the conversions between uniform
+ * and Gaussian sequences run in parallel; progress is only reported from the
+ * calling thread. Random sequences are still generated sequentially, so that
+ * a given seed always gives the same sequence.
  */
 
 class stegosystem {
@@ -87,30 +87,14 @@ void sum_prod_alg_gdl<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
          h_m_n = this-> marginal_probs(loop_m, pos).val;
          this->marginal_probs(loop_m, pos).q_mxn = this->received_probs(pos);
 
-         // If h_m_n is not 1 we need to permute the probs.
-         if (1 != h_m_n)
-            {
-            //In fact the probability we are given are not for the x_i but for
-            //the value h_m_n*xi hence all we need to do is copy the values into
-            //the array with a slightly amended index:
-            //probs(h_m_n*x)=received_prob(x) for all x in GF_q and 0!=h_m_n in GF_q.
-            // Declerq&Fossorier: Decoding Algs for non-binary LDPC Codes over GF(q)
-            for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
-               {
-               //perms(h_m_n)(loop)=GF_q(h_m_n)*GF_q(loop) - a look-up is quicker than a
-               //computation (I hope)
-               this ->marginal_probs(loop_m, pos).qmn_conv(this->perms(h_m_n)(
-                     loop_e)) = this->received_probs(pos)(loop_e);
-               }
-            }
-         else
-            {
-            //no permutation needed as h_m_n=1
-            this->marginal_probs(loop_m, pos).qmn_conv = this->received_probs(
-                  pos);
-            }
-         this ->compute_convs(this ->marginal_probs(loop_m, pos).qmn_conv, 0,
-               num_of_elements - 1);
+         //In fact the probability we are given are not for the x_i but for
+         //the value h_m_n*xi hence all we need to do is copy the values into
+         //the array with a slightly amended index:
+         //probs(h_m_n*x)=received_prob(x) for all x in GF_q and 0!=h_m_n in GF_q.
+         // Declerq&Fossorier: Decoding Algs for non-binary LDPC Codes over GF(q)
+         this->permute(this->received_probs(pos), h_m_n,
+               this->marginal_probs(loop_m, pos).qmn_conv);
+         this ->compute_convs(this ->marginal_probs(loop_m, pos).qmn_conv);
          }
       this->marginal_probs(loop_m, pos).r_mxn = 0.0;
       }
@@ -128,35 +112,53 @@ void sum_prod_alg_gdl<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
    }
 
 template <class GF_q, class real>
-void sum_prod_alg_gdl<GF_q, real>::compute_convs(array1d_t & conv_out,
-      int pos1, int pos2)
+void sum_prod_alg_gdl<GF_q, real>::compute_convs(array1d_t & conv_out)
    {
    //this is in fact the Hadamard transform using the butterfly property of
-   //the fast Fourier transform.
-   if ((pos2 - pos1) == 1)
+   //the fast Fourier transform; at each stage we combine pairs of elements
+   //that are 'half' positions apart, starting with adjacent ones.
+   const int num_of_elements = gf_elements<GF_q>::value;
+   assert(conv_out.size() == num_of_elements);
+   real* x = &conv_out(0);
+   for (int half = 1; half < num_of_elements; half <<= 1)
       {
-      real tmp1 = conv_out(pos1);
-      real tmp2 = conv_out(pos2);
-      conv_out(pos1) = tmp1 + tmp2;
-      conv_out(pos2) = tmp1 - tmp2;
-      }
-   else
-      {
-      int midpoint = pos1 + (pos2 - pos1 + 1) / 2;
-      this->compute_convs(conv_out, pos1, midpoint - 1);
-      this->compute_convs(conv_out, midpoint, pos2);
-      pos2 = midpoint;
-      for (int loop1 = pos1; loop1 < midpoint; loop1++)
+      for (int pos1 = 0; pos1 < num_of_elements; pos1 += 2 * half)
          {
-         real tmp1 = conv_out(loop1);
-         real tmp2 = conv_out(pos2);
-         conv_out(loop1) = tmp1 + tmp2;
-         conv_out(pos2) = tmp1 - tmp2;
-         pos2++;
+         real* a = x + pos1;
+         real* b = a + half;
+         for (int loop1 = 0; loop1 < half; loop1++)
+            {
+            const real tmp1 = a[loop1];
+            const real tmp2 = b[loop1];
+            a[loop1] = tmp1 + tmp2;
+            b[loop1] = tmp1 - tmp2;
+            }
          }
       }
    }
 
+template <class GF_q, class real>
+void sum_prod_alg_gdl<GF_q, real>::permute(const array1d_t& in, int h,
+      array1d_t& out) const
+   {
+   const int num_of_elements = gf_elements<GF_q>::value;
+   assert(in.size() == num_of_elements);
+   assert(out.size() == num_of_elements);
+   if (1 == h)
+      {
+      //no permutation needed as h=1
+      out = in;
+      return;
+      }
+   //perms(h)(loop)=GF_q(h)*GF_q(loop) - a look-up is quicker than a
+   //computation
+   const int* p = &this->perms(this->inverse(h))(0);
+   const real* src = &in(0);
+   real* dst = &out(0);
+   for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
+      dst[loop_e] = src[p[loop_e]];
+   }
+
 //specialisation for GF(2)
 template <>
 void sum_prod_alg_gdl<libbase::gf2 , double>::compute_r_mn(int m, int n,
@@ -189,7 +191,7 @@ void sum_prod_alg_gdl<GF_q, real>::compute_r_mn(int m, int n,
    {
    //the number of participating symbols
    int num_of_var_syms = tmpN_m.size();
-   int num_of_elements = GF_q::elements();
+   const int num_of_elements = gf_elements<GF_q>::value;
 
    int pos_n = tmpN_m(n) - 1;//we count from 1;
    //note the following should never be a division by zero!
@@ -200,23 +202,24 @@ void sum_prod_alg_gdl<GF_q, real>::compute_r_mn(int m, int n,
    array1d_t q_nm_conv_prod;
    q_nm_conv_prod.init(num_of_elements);
    q_nm_conv_prod = 1.0;
-   for (int loop2 = 1; loop2 < num_of_elements; loop2++)
+   real* prod = &q_nm_conv_prod(0);
+   for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
       {
-      for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
+      if (loop1 != n)
          {
-         if (loop1 != n)
-            {
-            pos_n_dash = tmpN_m(loop1) - 1;//we count from zero
-
-            //this uses the FFT of the q_mxn to work out the r_mn
-            q_nm_conv_prod(loop2)
-                  *= this->marginal_probs(m, pos_n_dash).qmn_conv(loop2);
-            }
+         pos_n_dash = tmpN_m(loop1) - 1;//we count from zero
+
+         //this uses the FFT of the q_mxn to work out the r_mn
+         //(element zero is the sum of probabilities and is left as 1)
+         const real* conv =
+               &this->marginal_probs(m, pos_n_dash).qmn_conv(0);
+         for (int loop2 = 1; loop2 < num_of_elements; loop2++)
+            prod[loop2] *= conv[loop2];
          }
       }
 
    //apply the FFT again to get the proper values
-   this->compute_convs(q_nm_conv_prod, 0, num_of_elements - 1);
+   this->compute_convs(q_nm_conv_prod);
 
    /*
     * ensure that the values in q_nm_conv_prod make sense, ie
@@ -236,13 +239,12 @@ void sum_prod_alg_gdl<GF_q, real>::compute_r_mn(int m, int n,
    assertalways(sum_qnm != real(0.0));
    q_nm_conv_prod /= sum_qnm;
 
+   //perms(h_m_n)(loop)=GF_q(h_m_n)*GF_q(loop) - a look-up is quicker than a
+   //computation
+   const int* p = &this->perms(h_m_n)(0);
+   real* r = &this->marginal_probs(m, pos_n).r_mxn(0);
    for (int loop1 = 0; loop1 < num_of_elements; loop1++)
-      {
-      //perms(h_m_n)(loop)=GF_q(h_m_n)*GF_q(loop) - a look-up is quicker than a
-      //computation (I hope)
-      this ->marginal_probs(m, pos_n).r_mxn(loop1) = q_nm_conv_prod(
-            this->perms(h_m_n)(loop1));
-      }
+      r[loop1] = prod[p[loop1]];
    }
 
 template <class GF_q, class real>
@@ -325,15 +327,8 @@ void sum_prod_alg_gdl<GF_q, real>::compute_q_mn(int m, int n,
    this->marginal_probs(pos_m, n).q_mxn = q_mn;
    //compute the FFT and store it for the next iteration
    int h_m_n = this->marginal_probs(pos_m, n).val;
-   for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
-      {
-      //perms(h_m_n)(loop)=GF_q(h_m_n)*GF_q(loop) - a look-up is quicker than a
-      //computation (I hope)
-      this ->marginal_probs(pos_m, n).qmn_conv(this->perms(h_m_n)(loop_e))
-            = q_mn(loop_e);
-      }
-   this ->compute_convs(this ->marginal_probs(pos_m, n).qmn_conv, 0,
-         num_of_elements - 1);
+   this->permute(q_mn, h_m_n, this->marginal_probs(pos_m, n).qmn_conv);
+   this ->compute_convs(this ->marginal_probs(pos_m, n).qmn_conv);
 
    }
 
@@ -23,10 +23,26 @@
 #define SUM_PROD_ALG_GDL_H_
 
 #include "sum_prod_alg_abstract.h"
+#include "gf.h"
 #include <string>
 
 namespace libcomm {
 
+/*!
+ * \brief Number of field elements, as a compile-time constant
+ * This allows the transform loops to be fully specialized (and vectorized)
+ * for each field size.
+ */
+template <class GF_q>
+struct gf_elements;
+
+template <int m, int poly>
+struct gf_elements<libbase::gf<m, poly> > {
+   enum {
+      value = 1 << m
+   };
+};
+
 template <class GF_q, class real = double>
 class sum_prod_alg_gdl : public sum_prod_alg_abstract<GF_q, real> {
 public:
@@ -68,6 +84,8 @@ public:
       this->perms.init(num_of_elements);
       this->perms(0).init(num_of_elements);
       this->perms(0) = 0; //note this is by convention and not used anywhere
+      this->inverse.init(num_of_elements);
+      this->inverse(0) = 0; //note this is by convention and not used anywhere
 
       for (int loop1 = 1; loop1 < num_of_elements; loop1++)
          {
@@ -78,6 +96,7 @@ public:
             this ->perms(loop1)(pos) = GF_q(loop_e) * GF_q(loop1);
             pos++;
             }
+         this->inverse(loop1) = GF_q(loop1).inverse();
          }
       }
    virtual ~sum_prod_alg_gdl()
@@ -95,7 +114,9 @@ public:
 private:
    /*! \brief compute the Fast Hadamard transform
     * This method will compute the Fast Fourier Transform of the
-    * elements passed in through conv_out. It does this recursively.
+    * elements passed in through conv_out. It does this iteratively and
+    * in-place, with the field size fixed at compile time; the butterflies
+    * at each stage are independent, so the compiler can vectorize them.
     * Note the result is equivalent to the following matrix-vector
     * multiplication:
     * Let m be the size of conv_out, ie m=|GF_q|=power of 2
@@ -108,13 +129,22 @@ private:
     * conv_out^t is the transpose of the conv_out vector
     *
     */
-   void compute_convs(array1d_t & conv_out, int pos1, int pos2);
+   void compute_convs(array1d_t & conv_out);
+   /*! \brief permute probabilities by a field element
+    * Sets out(h*x)=in(x) for all x in GF_q, where 0!=h in GF_q. This is done
+    * as a gather with the inverse permutation, ie out(y)=in(h^{-1}*y).
+    */
+   void permute(const array1d_t& in, int h, array1d_t& out) const;
 
 private:
    /*! \brief this holds a look-up table of the finite field multiplication
     *
     */
    array1vi_t perms;
+   /*! \brief this holds a look-up table of the multiplicative inverses
+    *
+    */
+   array1i_t inverse;
 
 };
 
@@ -20,6 +20,7 @@
  */
 
 #include "filter.h"
+#include <algorithm>
 
 namespace libimage {
 
@@ -35,6 +36,48 @@ void filter<T>::apply(const libbase::matrix<T>& in,
    process(in, out);
    }
 
+template <class T>
+void filter<T>::apply(imagefile& in, imagefile& out, const int band)
+   {
+   const int M = in.rows();
+   const int N = in.cols();
+   assertalways(out.rows() == M && out.cols() == N);
+   assertalways(out.channels() == in.channels());
+   // determine band size and count
+   const int h = halo();
+   const int B = (h < 0) ? std::max(M, 1) : std::max(band, 1);
+   const int bands = (M + B - 1) / B;
+   for (int c = 0; c < in.channels(); c++)
+      {
+      // parameter estimation (updates internal statistics)
+      reset();
+      for (int b = 0; b < bands; b++)
+         {
+         libbase::matrix<T> x;
+         in.read(b * B, std::min(M, (b + 1) * B), c, x);
+         update(x);
+         }
+      estimate();
+      // filter process loop, with each band extended by the halo
+#pragma omp parallel for schedule(dynamic)
+      for (int b = 0; b < bands; b++)
+         {
+         const int r0 = b * B;
+         const int r1 = std::min(M, r0 + B);
+         const int h0 = (h < 0) ? 0 : std::max(0, r0 - h);
+         const int h1 = (h < 0) ? M : std::min(M, r1 + h);
+         libbase::matrix<T> x, y;
+         in.read(h0, h1, c, x);
+         process(x, y);
+         libbase::matrix<T> z(r1 - r0, N);
+         for (int i = r0; i < r1; i++)
+            for (int j = 0; j < N; j++)
+               z(i - r0, j) = y(i - h0, j);
+         out.write(r0, c, z);
+         }
+      }
+   }
+
 // Explicit Realizations
 
 template class filter<double> ;
@@ -24,6 +24,7 @@
 
 #include "config.h"
 #include "matrix.h"
+#include "imagefile.h"
 
 namespace libimage {
 
@@ -36,6 +37,14 @@ namespace libimage {
  * The first pass gathers details from the image, tile by tile, while the
  * second pass uses the gathered information for any parameter estimates
  * (such as automatic thresholds, etc) and applies the filter to the image.
+ *
+ * Images held in files can be filtered a band of rows at a time. Filters
+ * that only look at a bounded neighbourhood of each pixel declare its reach
+ * through halo(); each band is then processed together with that many rows
+ * above and below it, so that the result is the same as for the whole
+ * image. Bands are processed in parallel. Parameter estimation sees each
+ * band without its halo, so neighbourhood statistics gathered in the first
+ * pass are clipped at band boundaries.
  */
 
 template <class T>
@@ -53,8 +62,17 @@ public:
    //! Filter process loop (only updates output matrix)
    virtual void
    process(const libbase::matrix<T>& in, libbase::matrix<T>& out) const = 0;
+   /*! \brief Number of neighbouring rows needed to filter a row
+    * A negative value means the filter needs the whole image at once.
+    */
+   virtual int halo() const
+      {
+      return -1;
+      }
    //! Apply filter to an image channel
    void apply(const libbase::matrix<T>& in, libbase::matrix<T>& out);
+   //! Apply filter to all channels of an image file, in bands of given size
+   void apply(imagefile& in, imagefile& out, const int band);
 };
 
 
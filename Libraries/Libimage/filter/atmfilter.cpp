@@ -20,12 +20,44 @@
  */
 
 #include "atmfilter.h"
-#include <list>
+#include "neighbourhood.h"
 #include <algorithm>
-#include <numeric>
 
 namespace libimage {
 
+/*!
+ * \brief Update window contents for a change of neighbourhood
+ * Pixels in 'from' but not in 'to' are removed, and pixels in 'to' but not
+ * in 'from' are inserted; 'rank' holds the ranks of rows from 'r0'.
+ */
+template <class T>
+void move_window(order_window& ow, const libbase::matrix<T>& in,
+      const libbase::matrix<int>& rank, const int r0, const window& from,
+      const window& to)
+   {
+   for (int i = from.r0; i <= from.r1; i++)
+      for (int j = from.c0; j <= from.c1; j++)
+         {
+         if (i >= to.r0 && i <= to.r1 && j >= to.c0 && j <= to.c1)
+            {
+            // skip over the overlap
+            j = to.c1;
+            continue;
+            }
+         ow.remove(rank(i - r0, j), double(in(i, j)));
+         }
+   for (int i = to.r0; i <= to.r1; i++)
+      for (int j = to.c0; j <= to.c1; j++)
+         {
+         if (i >= from.r0 && i <= from.r1 && j >= from.c0 && j <= from.c1)
+            {
+            j = from.c1;
+            continue;
+            }
+         ow.insert(rank(i - r0, j), double(in(i, j)));
+         }
+   }
+
 // initialization
 
 template <class T>
@@ -37,45 +69,65 @@ void atmfilter<T>::init(const int d, const int alpha)
 
 // filter process loop (only updates output matrix)
 
+/*!
+ * \brief Process rows [i0,i1)
+ * Pixels within reach of the band are ranked first; the neighbourhood then
+ * moves along alternate directions on successive rows, so that each step
+ * (including the step down to the next row) changes only one strip.
+ */
 template <class T>
-void atmfilter<T>::process(const libbase::matrix<T>& in,
-      libbase::matrix<T>& out) const
+void atmfilter<T>::process_band(const libbase::matrix<T>& in,
+      libbase::matrix<T>& out, const int i0, const int i1, int& done) const
    {
    const int M = in.size().rows();
    const int N = in.size().cols();
 
-   out.init(M, N);
-   std::list<T> lst;
-
-   for (int i = 0; i < M; i++)
+   const int r0 = std::max(i0 - m_d, 0);
+   const int r1 = std::min(i1 - 1 + m_d, M - 1);
+   libbase::matrix<int> rank;
+   order_window ow;
+   ow.init(rank_band(in, r0, r1, rank));
+   // start with an empty neighbourhood
+   window cur(i0, 0, m_d, M, N);
+   cur.r1 = cur.r0 - 1;
+   for (int i = i0; i < i1; i++)
       {
-      display_progress(i, M);
-      for (int j = 0; j < N; j++)
+      for (int k = 0; k < N; k++)
          {
-         // create list of neighbouring pixels
-         lst.clear();
-         for (int ii = std::max(i - m_d, 0); ii <= std::min(i + m_d, M - 1); ii++)
-            for (int jj = std::max(j - m_d, 0); jj <= std::min(j + m_d, N - 1); jj++)
-               lst.push_back(in(ii, jj));
-         // sort the list
-         lst.sort();
-         // erase the first and last alpha elements
-         typename std::list<T>::iterator p1 = lst.begin();
-         typename std::list<T>::iterator p2 = lst.end();
-         for (int k = 0; k < m_alpha; k++)
-            {
-            p1++;
-            p2--;
-            }
+         const int j = ((i - i0) % 2 == 0) ? k : N - 1 - k;
+         const window w(i, j, m_d, M, N);
+         move_window(ow, in, rank, r0, cur, w);
+         cur = w;
          // compute the mean, skipping the first and last alpha elements
-         const int n = lst.size() - 2 * m_alpha;
-         T d = 0;
-         d = accumulate(p1, p2, d);
-         out(i, j) = d / n;
+         const int n = w.size() - 2 * m_alpha;
+         const double d = ow.sum_smallest(w.size() - m_alpha)
+               - ow.sum_smallest(m_alpha);
+         out(i, j) = T(d / n);
          }
+#pragma omp atomic
+      done++;
+      if (libbase::getthreadid() == 0)
+         display_progress(done, M);
       }
    }
 
+template <class T>
+void atmfilter<T>::process(const libbase::matrix<T>& in,
+      libbase::matrix<T>& out) const
+   {
+   const int M = in.size().rows();
+
+   out.init(M, in.size().cols());
+
+   // split rows into bands, processed independently
+   const int bands = std::min(M, 4 * libbase::getthreadcount());
+   int done = 0;
+#pragma omp parallel for schedule(dynamic)
+   for (int b = 0; b < bands; b++)
+      process_band(in, out, int(libbase::int64s(M) * b / bands),
+            int(libbase::int64s(M) * (b + 1) / bands), done);
+   }
+
 // Explicit Realizations
 
 template class atmfilter<double> ;
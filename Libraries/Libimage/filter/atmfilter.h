@@ -31,6 +31,11 @@ namespace libimage {
  * \author  Johann Briffa
  *
  * This filter computes the alpha-trimmed mean within a given neighbourhood.
+ *
+ * The image is split into bands of rows, processed in parallel; within each
+ * band the neighbourhood slides along a serpentine path, with its contents
+ * kept in an order_window so that each step only inserts and removes the
+ * pixels entering and leaving the neighbourhood.
  */
 
 template <class T>
@@ -38,6 +43,9 @@ class atmfilter : public filter<T> {
 protected:
    int m_d; //!< greatest distance from current pixel in neighbourhood
    int m_alpha; //!< number of outliers to trim at each end before computing mean
+protected:
+   void process_band(const libbase::matrix<T>& in, libbase::matrix<T>& out,
+         const int i0, const int i1, int& done) const;
 public:
    atmfilter(const int d, const int alpha)
       {
@@ -45,6 +53,11 @@ public:
       }
    // initialization
    void init(const int d, const int alpha);
+   // neighbourhood reach
+   int halo() const
+      {
+      return m_d;
+      }
    // progress display
    void display_progress(const int done, const int total) const
       {
@@ -20,6 +20,7 @@
  */
 
 #include "awfilter.h"
+#include "neighbourhood.h"
 
 namespace libimage {
 
@@ -59,18 +60,17 @@ void awfilter<T>::update(const libbase::matrix<T>& in)
    const int M = in.size().rows();
    const int N = in.size().cols();
 
+   const integral_image sat(in);
    for (int i = 0; i < M; i++)
       {
       display_progress(i, M);
       for (int j = 0; j < N; j++)
          {
          // compute mean and variance of neighbouring pixels
-         libbase::rvstatistics rv;
-         for (int ii = std::max(i - m_d, 0); ii <= std::min(i + m_d, M - 1); ii++)
-            for (int jj = std::max(j - m_d, 0); jj <= std::min(j + m_d, N - 1); jj++)
-               rv.insert(in(ii, jj));
+         double mean, var;
+         sat.stats(window(i, j, m_d, M, N), mean, var);
          // add to the global sum
-         rvglobal.insert(rv.var());
+         rvglobal.insert(var);
          }
       }
    }
@@ -95,22 +95,24 @@ void awfilter<T>::process(const libbase::matrix<T>& in, libbase::matrix<T>& out)
 
    out.init(M, N);
 
+   const integral_image sat(in);
+   int done = 0;
+#pragma omp parallel for schedule(dynamic)
    for (int i = 0; i < M; i++)
       {
-      display_progress(i, M);
       for (int j = 0; j < N; j++)
          {
          // compute mean and variance of neighbouring pixels
-         libbase::rvstatistics rv;
-         for (int ii = std::max(i - m_d, 0); ii <= std::min(i + m_d, M - 1); ii++)
-            for (int jj = std::max(j - m_d, 0); jj <= std::min(j + m_d, N - 1); jj++)
-               rv.insert(in(ii, jj));
-         const double mean = rv.mean();
-         const double var = rv.var();
+         double mean, var;
+         sat.stats(window(i, j, m_d, M, N), mean, var);
          // compute result
          out(i, j) = T(mean + (std::max<double>(0, var - m_noise) / std::max<
                double>(var, m_noise)) * (in(i, j) - mean));
          }
+#pragma omp atomic
+      done++;
+      if (libbase::getthreadid() == 0)
+         display_progress(done, M);
       }
    }
 
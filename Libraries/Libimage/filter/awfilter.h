@@ -37,6 +37,9 @@ namespace libimage {
  * variance itself - this is actually computed as the mean value of the image
  * local variance. This class allows this to be done by using the appropriate
  * constructor. The estimator function is also publicly available.
+ *
+ * Neighbourhood mean and variance are obtained in constant time from a
+ * summed-area table (integral_image); rows are filtered in parallel.
  */
 
 template <class T>
@@ -60,6 +63,11 @@ public:
    // initialization
    void init(const int d, const double noise);
    void init(const int d);
+   // neighbourhood reach
+   int halo() const
+      {
+      return m_d;
+      }
    // progress display
    void display_progress(const int done, const int total) const
       {
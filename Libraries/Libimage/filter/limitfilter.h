@@ -51,6 +51,11 @@ public:
       }
    // initialization
    void init(const T lo, const T hi);
+   // pointwise filter needs no neighbours
+   int halo() const
+      {
+      return 0;
+      }
    // progress display
    void display_progress(const int done, const int total) const
       {
@@ -20,7 +20,7 @@
  */
 
 #include "variancefilter.h"
-#include "rvstatistics.h"
+#include "neighbourhood.h"
 
 namespace libimage {
 
@@ -43,15 +43,15 @@ void variancefilter<T>::process(const libbase::matrix<T>& in,
 
    out.init(M, N);
 
+   const integral_image sat(in);
+#pragma omp parallel for schedule(dynamic)
    for (int i = 0; i < M; i++)
       for (int j = 0; j < N; j++)
          {
          // compute the variance of neighbouring pixels
-         libbase::rvstatistics r;
-         for (int ii = std::max(i - m_d, 0); ii <= std::min(i + m_d, M - 1); ii++)
-            for (int jj = std::max(j - m_d, 0); jj <= std::min(j + m_d, N - 1); jj++)
-               r.insert(double(in(ii, jj)));
-         out(i, j) = T(r.var());
+         double mean, var;
+         sat.stats(window(i, j, m_d, M, N), mean, var);
+         out(i, j) = T(var);
          }
    }
 
@@ -33,6 +33,10 @@
 
  Version 1.20 (10 Nov 2006)
  * defined class and associated data within "libimage" namespace.
+
+ Version 1.30
+ * local variance is obtained from a summed-area table, in constant time per
+ pixel; rows are processed in parallel.
  */
 
 namespace libimage {
@@ -54,6 +58,11 @@ public:
       }
    // initialization
    void init(const int d);
+   // neighbourhood reach
+   int halo() const
+      {
+      return m_d;
+      }
    // progress display
    void display_progress(const int done, const int total) const
       {
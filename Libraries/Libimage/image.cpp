@@ -25,9 +25,45 @@
 #include <sstream>
 #include <string>
 #include <typeinfo>
+#include <vector>
+#include <cctype>
+#include <cstdio>
 
 namespace libimage {
 
+// Internal functions
+
+/*! \brief Read a non-negative decimal integer from a text image
+ * This works directly on the stream buffer, skipping any whitespace and
+ * comments before the number; the stream's failbit is set on error.
+ */
+template <class T>
+int image<T>::read_ascii(std::istream& sin)
+   {
+   std::streambuf* sb = sin.rdbuf();
+   int ch = sb->sgetc();
+   while (ch != EOF && (isspace(ch) || ch == '#'))
+      {
+      if (ch == '#')
+         while (ch != EOF && ch != '\n')
+            ch = sb->snextc();
+      else
+         ch = sb->snextc();
+      }
+   if (ch == EOF || !isdigit(ch))
+      {
+      sin.setstate(std::ios::failbit);
+      return 0;
+      }
+   int v = 0;
+   while (ch != EOF && isdigit(ch))
+      {
+      v = v * 10 + (ch - '0');
+      ch = sb->snextc();
+      }
+   return v;
+   }
+
 // Saving/loading functions
 
 template <class T>
@@ -57,8 +93,11 @@ std::ostream& image<T>::serialize(std::ostream& sout) const
    // if needed, write maxval
    if (chan > 1 || m_maxval > 1)
       sout << m_maxval << std::endl;
-   // write image data
+   // write image data, a row at a time
+   std::vector<char> buf(cols * chan * (m_maxval > 255 ? 2 : 1));
    for (int i = 0; i < rows; i++)
+      {
+      int k = 0;
       for (int j = 0; j < cols; j++)
          for (int c = 0; c < chan; c++)
             {
@@ -70,11 +109,13 @@ std::ostream& image<T>::serialize(std::ostream& sout) const
             assert(p >= 0 && p <= m_maxval);
             if (m_maxval > 255) // 16-bit binary files (MSB first)
                {
-               sout.put(p >> 8);
+               buf[k++] = char(p >> 8);
                p &= 0xff;
                }
-            sout.put(p);
+            buf[k++] = char(p);
             }
+      sout.write(&buf[0], k);
+      }
    // done
    libbase::trace << "done" << std::endl;
    return sout;
@@ -101,7 +142,7 @@ std::istream& image<T>::serialize(std::istream& sin)
    else
       chan = 1;
    // determine the data format
-   if (descriptor >= 4 || descriptor <= 6)
+   if (descriptor >= 4 && descriptor <= 6)
       binary = true;
    else
       binary = false;
@@ -130,22 +171,30 @@ std::istream& image<T>::serialize(std::istream& sin)
    m_data.init(chan);
    for (int c = 0; c < chan; c++)
       m_data(c).init(rows, cols);
-   // read image data
-   for (int i = 0; i < rows; i++)
+   // read image data, a row at a time for binary files
+   const int b = (m_maxval > 255) ? 2 : 1;
+   std::vector<char> buf(binary ? cols * chan * b : 0);
+   for (int i = 0; i < rows && sin; i++)
+      {
+      if (binary)
+         sin.read(&buf[0], buf.size());
+      const unsigned char* p = reinterpret_cast<const unsigned char*> (
+            binary ? &buf[0] : NULL);
       for (int j = 0; j < cols; j++)
          for (int c = 0; c < chan; c++)
             {
             if (binary)
                {
-               int p = sin.get();
-               if (m_maxval > 255) // 16-bit binary files (MSB first)
-                  p = (p << 8) + sin.get();
-               m_data(c)(i, j) = T(p);
+               // 16-bit binary files are MSB first
+               const int v = (b == 2) ? (p[0] << 8) | p[1] : p[0];
+               p += b;
+               m_data(c)(i, j) = T(v);
                }
             else
-               sin >> m_data(c)(i, j);
+               m_data(c)(i, j) = T(read_ascii(sin));
             assert(m_data(c)(i, j) >= 0 && m_data(c)(i, j) <= m_maxval);
             }
+      }
    assertalways(sin);
    // scale down if we're using floating-point
    if (is_scaled())
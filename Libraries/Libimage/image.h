@@ -50,6 +50,8 @@ private:
    T m_hi;
    int m_maxval;
 protected:
+   //! Read a number from a text image
+   static int read_ascii(std::istream& sin);
    //! Returns true if pixel values are scaled to [0.0,1.0]
    static bool is_scaled()
       {
@@ -20,15 +20,288 @@
  */
 
 #include "imagefile.h"
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <vector>
+#include <sstream>
+#include <typeinfo>
+
+#ifndef _WIN32
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
 
 namespace libimage {
 
-imagefile::imagefile()
+// Internal functions
+
+/*! \brief Interpret a binary PNM header
+ * Sets the image size and range, and the offset of the pixel data, which
+ * follows the single whitespace character after the last header field.
+ */
+void imagefile::parse_header(const std::string& header)
+   {
+   size_t pos = 0;
+   int field[4];
+   for (int k = 0; k < 4; k++)
+      {
+      // skip whitespace and comments
+      while (pos < header.size() && (isspace(header[pos]) || header[pos]
+            == '#'))
+         {
+         if (header[pos] == '#')
+            while (pos < header.size() && header[pos] != '\n')
+               pos++;
+         else
+            pos++;
+         }
+      // read field (the magic number is read without its leading 'P')
+      if (k == 0)
+         {
+         assertalways(pos < header.size() && header[pos] == 'P');
+         pos++;
+         }
+      assertalways(pos < header.size() && isdigit(header[pos]));
+      field[k] = 0;
+      while (pos < header.size() && isdigit(header[pos]))
+         field[k] = field[k] * 10 + (header[pos++] - '0');
+      }
+   assertalways(pos < header.size() && isspace(header[pos]));
+   if (field[0] != 5 && field[0] != 6)
+      failwith("Only binary graymaps and pixmaps (P5/P6) are supported");
+   m_chan = (field[0] == 6) ? 3 : 1;
+   m_cols = field[1];
+   m_rows = field[2];
+   m_maxval = field[3];
+   assertalways(m_maxval > 1 && m_maxval < 65536);
+   m_start = pos + 1;
+   }
+
+/*! \brief Set up access to the pixel data
+ * The file is memory-mapped where possible; otherwise it is left open for
+ * seeking.
+ */
+void imagefile::map(const bool writable)
+   {
+   m_writable = writable;
+   m_map = NULL;
+   m_length = m_start + row_bytes() * m_rows;
+#ifndef _WIN32
+   const int fd = ::open(m_name.c_str(), writable ? O_RDWR : O_RDONLY);
+   assertalways(fd >= 0);
+   struct stat s;
+   assertalways(fstat(fd, &s) == 0 && size_t(s.st_size) >= m_length);
+   void* p = mmap(NULL, m_length, writable ? PROT_READ | PROT_WRITE
+         : PROT_READ, MAP_SHARED, fd, 0);
+   ::close(fd);
+   if (p != MAP_FAILED)
+      {
+      m_map = static_cast<char*> (p);
+      return;
+      }
+#endif
+   m_file.open(m_name.c_str(), writable ? std::ios::in | std::ios::out
+         | std::ios::binary : std::ios::in | std::ios::binary);
+   assertalways(m_file);
+   }
+
+void imagefile::get_rows(const int r0, const int r1, char* buf)
+   {
+   assert(r0 >= 0 && r0 <= r1 && r1 <= m_rows);
+   const size_t offset = m_start + row_bytes() * r0;
+   const size_t length = row_bytes() * (r1 - r0);
+   if (m_map)
+      {
+      std::memcpy(buf, m_map + offset, length);
+      return;
+      }
+#pragma omp critical(imagefile)
+      {
+      m_file.seekg(offset);
+      m_file.read(buf, length);
+      assertalways(m_file);
+      }
+   }
+
+void imagefile::put_rows(const int r0, const int r1, const char* buf)
+   {
+   assert(r0 >= 0 && r0 <= r1 && r1 <= m_rows);
+   assertalways(m_writable);
+   const size_t offset = m_start + row_bytes() * r0;
+   const size_t length = row_bytes() * (r1 - r0);
+   if (m_map)
+      {
+      std::memcpy(m_map + offset, buf, length);
+      return;
+      }
+#pragma omp critical(imagefile)
+      {
+      m_file.seekp(offset);
+      m_file.write(buf, length);
+      assertalways(m_file);
+      }
+   }
+
+// Construction / destruction
+
+imagefile::imagefile() :
+   m_rows(0), m_cols(0), m_chan(0), m_maxval(0), m_start(0), m_map(NULL),
+         m_length(0), m_writable(false)
    {
    }
 
 imagefile::~imagefile()
    {
+   close();
+   }
+
+// File access
+
+/*! \brief Open an existing image file for reading
+ */
+void imagefile::open(const std::string& fname)
+   {
+   close();
+   m_name = fname;
+   // read enough of the file to hold the header
+   std::ifstream file(fname.c_str(), std::ios::in | std::ios::binary);
+   assertalways(file);
+   std::string header(4096, 0);
+   file.read(&header[0], header.size());
+   header.resize(file.gcount());
+   file.close();
+   parse_header(header);
+   map(false);
    }
 
+/*! \brief Create a new image file of the given size, for writing
+ * The file is written with the same header as libimage::image, and all
+ * pixels are initially zero.
+ */
+void imagefile::create(const std::string& fname, const int rows,
+      const int cols, const int chan, const int maxval)
+   {
+   close();
+   m_name = fname;
+   if (chan != 1 && chan != 3)
+      failwith("Image format not supported");
+   assertalways(maxval > 1 && maxval < 65536);
+   m_rows = rows;
+   m_cols = cols;
+   m_chan = chan;
+   m_maxval = maxval;
+   // write header
+   std::ostringstream header;
+   header << (chan == 1 ? "P5" : "P6") << std::endl;
+   header << "# file written by libimage" << std::endl;
+   header << cols << " " << rows << std::endl;
+   header << maxval << std::endl;
+   m_start = header.str().size();
+      {
+      std::ofstream file(fname.c_str(), std::ios::out | std::ios::binary
+            | std::ios::trunc);
+      assertalways(file);
+      file << header.str();
+      // extend to full size
+      const size_t length = m_start + row_bytes() * m_rows;
+      if (length > m_start)
+         {
+         file.seekp(length - 1);
+         file.put(0);
+         }
+      assertalways(file);
+      }
+   map(true);
+   }
+
+void imagefile::close()
+   {
+#ifndef _WIN32
+   if (m_map)
+      munmap(m_map, m_length);
+#endif
+   m_map = NULL;
+   if (m_file.is_open())
+      m_file.close();
+   m_file.clear();
+   }
+
+// Band access
+
+template <class T>
+void imagefile::read(const int r0, const int r1, const int c,
+      libbase::matrix<T>& x)
+   {
+   assert(c >= 0 && c < m_chan);
+   const int rows = r1 - r0;
+   std::vector<char> buf(row_bytes() * rows + 1);
+   get_rows(r0, r1, &buf[0]);
+   const bool scaled = typeid(T) == typeid(double) || typeid(T)
+         == typeid(float);
+   const int b = sample_bytes();
+   const unsigned char* p = reinterpret_cast<const unsigned char*> (&buf[0])
+         + c * b;
+   const int stride = m_chan * b;
+   x.init(rows, m_cols);
+   for (int i = 0; i < rows; i++)
+      for (int j = 0; j < m_cols; j++, p += stride)
+         {
+         // 16-bit samples are MSB first
+         const int v = (b == 2) ? (p[0] << 8) | p[1] : p[0];
+         x(i, j) = scaled ? T(v) / T(m_maxval) : T(v);
+         }
+   }
+
+template <class T>
+void imagefile::write(const int r0, const int c, const libbase::matrix<T>& x)
+   {
+   assert(c >= 0 && c < m_chan);
+   assert(x.size().cols() == m_cols);
+   const int rows = x.size().rows();
+   std::vector<char> buf(row_bytes() * rows + 1);
+   // keep other channels' samples in interleaved files
+   if (m_chan > 1)
+      get_rows(r0, r0 + rows, &buf[0]);
+   const bool scaled = typeid(T) == typeid(double) || typeid(T)
+         == typeid(float);
+   const int b = sample_bytes();
+   unsigned char* p = reinterpret_cast<unsigned char*> (&buf[0]) + c * b;
+   const int stride = m_chan * b;
+   for (int i = 0; i < rows; i++)
+      for (int j = 0; j < m_cols; j++, p += stride)
+         {
+         const int v = scaled ? int(round(x(i, j) * m_maxval)) : int(x(i, j));
+         assert(v >= 0 && v <= m_maxval);
+         if (b == 2)
+            {
+            p[0] = (unsigned char) (v >> 8);
+            p[1] = (unsigned char) (v & 0xff);
+            }
+         else
+            p[0] = (unsigned char) v;
+         }
+   put_rows(r0, r0 + rows, &buf[0]);
+   }
+
+} // end namespace
+
+namespace libimage {
+
+// Explicit Realizations
+#include <boost/preprocessor/seq/for_each.hpp>
+
+#define SYMBOL_TYPE_SEQ \
+   (int)(float)(double)
+
+#define INSTANTIATE(r, x, type) \
+      template void imagefile::read<type>(const int r0, const int r1, \
+            const int c, libbase::matrix<type>& x); \
+      template void imagefile::write<type>(const int r0, const int c, \
+            const libbase::matrix<type>& x);
+
+BOOST_PP_SEQ_FOR_EACH(INSTANTIATE, x, SYMBOL_TYPE_SEQ)
+
 } // end namespace
@@ -23,6 +23,9 @@
 #define __imagefile_h
 
 #include "config.h"
+#include "matrix.h"
+#include <string>
+#include <fstream>
 
 /*******************************************************************************
 
@@ -33,20 +36,86 @@
  * this is effectively a container for images, together with the functions
  necessary to save and load to files or other streams.
 
+ Version 1.10
+ * implemented as random access to binary PNM files (P5/P6), so that large
+ images can be processed a band of rows at a time in bounded memory.
+ * files are memory-mapped where supported, and otherwise accessed by seeking;
+ bands of different rows may be read or written from several threads.
+
  *******************************************************************************/
 
 namespace libimage {
 
 class imagefile {
+private:
+   /*! \name Image header */
+   int m_rows, m_cols, m_chan, m_maxval;
+   // @}
+   /*! \name File access */
+   std::string m_name; //!< File name
+   size_t m_start; //!< Offset of pixel data
+   char* m_map; //!< Mapped file contents, if mapped
+   size_t m_length; //!< Length of mapped file
+   std::fstream m_file; //!< File stream, if not mapped
+   bool m_writable; //!< Whether file was created for writing
+   // @}
+private:
+   //! Number of bytes per sample
+   int sample_bytes() const
+      {
+      return (m_maxval > 255) ? 2 : 1;
+      }
+   //! Number of bytes per row
+   size_t row_bytes() const
+      {
+      return size_t(m_cols) * m_chan * sample_bytes();
+      }
+   void parse_header(const std::string& header);
+   void map(const bool writable);
+   void get_rows(const int r0, const int r1, char* buf);
+   void put_rows(const int r0, const int r1, const char* buf);
 public:
    // Construction / destruction
    imagefile();
    ~imagefile();
 
-   // File format
+   // File access
+   void open(const std::string& fname);
+   void create(const std::string& fname, const int rows, const int cols,
+         const int chan, const int maxval);
+   void close();
 
-   // Saving / loading
+   /*! \name Information functions */
+   int rows() const
+      {
+      return m_rows;
+      }
+   int cols() const
+      {
+      return m_cols;
+      }
+   int channels() const
+      {
+      return m_chan;
+      }
+   //! Maximum pixel value in file
+   int range() const
+      {
+      return m_maxval;
+      }
+   // @}
 
+   /*! \name Band access
+    * Pixel values are scaled to [0,1] for floating-point types, as with
+    * libimage::image.
+    */
+   //! Read rows [r0,r1) of channel 'c'
+   template <class T>
+   void read(const int r0, const int r1, const int c, libbase::matrix<T>& x);
+   //! Write channel 'c' of rows starting at r0
+   template <class T>
+   void write(const int r0, const int c, const libbase::matrix<T>& x);
+   // @}
 };
 
 } // end namespace
@@ -0,0 +1,219 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __neighbourhood_h
+#define __neighbourhood_h
+
+#include "config.h"
+#include "matrix.h"
+#include <vector>
+#include <algorithm>
+
+namespace libimage {
+
+/*!
+ * \brief   Square neighbourhood of a pixel
+ * \author  Johann Briffa
+ *
+ * Holds the rows [r0,r1] and columns [c0,c1] of the neighbourhood of
+ * greatest distance 'd' about a pixel, clipped to the image bounds.
+ */
+
+class window {
+public:
+   int r0, r1, c0, c1;
+public:
+   window(const int i, const int j, const int d, const int M, const int N) :
+      r0(std::max(i - d, 0)), r1(std::min(i + d, M - 1)),
+            c0(std::max(j - d, 0)), c1(std::min(j + d, N - 1))
+      {
+      }
+   //! Number of pixels in the neighbourhood
+   int size() const
+      {
+      return (r1 - r0 + 1) * (c1 - c0 + 1);
+      }
+   //! Whether pixel (i,j) lies in the neighbourhood
+   bool contains(const int i, const int j) const
+      {
+      return i >= r0 && i <= r1 && j >= c0 && j <= c1;
+      }
+};
+
+/*!
+ * \brief   Summed-area Table
+ * \author  Johann Briffa
+ *
+ * Holds cumulative sums of pixel values and their squares, so that the mean
+ * and variance over any rectangular neighbourhood are found in constant
+ * time. Values are offset by the image mean before accumulation, which keeps
+ * the difference of large sums from swamping the variance.
+ *
+ * Results follow the definitions used by libbase::rvstatistics.
+ */
+
+class integral_image {
+private:
+   int M, N;
+   double offset; //!< Value subtracted from each pixel before accumulation
+   std::vector<double> s1; //!< Sums of values, (M+1)x(N+1) with zero border
+   std::vector<double> s2; //!< Sums of squared values, as above
+private:
+   //! Sum of 'table' over window 'w'
+   double sum(const std::vector<double>& table, const window& w) const
+      {
+      const int W = N + 1;
+      return table[(w.r1 + 1) * W + (w.c1 + 1)] - table[w.r0 * W + (w.c1 + 1)]
+            - table[(w.r1 + 1) * W + w.c0] + table[w.r0 * W + w.c0];
+      }
+public:
+   template <class T>
+   explicit integral_image(const libbase::matrix<T>& in);
+   //! Mean and variance of neighbourhood 'w'
+   void stats(const window& w, double& mean, double& var) const
+      {
+      const double n = w.size();
+      const double m = sum(s1, w) / n;
+      const double v = sum(s2, w) / n - m * m;
+      mean = m + offset;
+      var = (v > 0) ? v : 0;
+      }
+};
+
+template <class T>
+integral_image::integral_image(const libbase::matrix<T>& in)
+   {
+   M = in.size().rows();
+   N = in.size().cols();
+   const int W = N + 1;
+   // determine offset
+   double total = 0;
+   for (int i = 0; i < M; i++)
+      for (int j = 0; j < N; j++)
+         total += double(in(i, j));
+   offset = (M * N > 0) ? total / (M * N) : 0;
+   // accumulate
+   s1.assign((M + 1) * W, 0);
+   s2.assign((M + 1) * W, 0);
+   for (int i = 0; i < M; i++)
+      {
+      double r1 = 0, r2 = 0;
+      for (int j = 0; j < N; j++)
+         {
+         const double x = double(in(i, j)) - offset;
+         r1 += x;
+         r2 += x * x;
+         s1[(i + 1) * W + (j + 1)] = s1[i * W + (j + 1)] + r1;
+         s2[(i + 1) * W + (j + 1)] = s2[i * W + (j + 1)] + r2;
+         }
+      }
+   }
+
+/*!
+ * \brief   Sliding-window Order Statistics
+ * \author  Johann Briffa
+ *
+ * Keeps the multiset of values in a sliding neighbourhood as a binary
+ * indexed (Fenwick) tree over value ranks, holding the count and the sum of
+ * values below each rank. Inserting or removing a pixel and finding the sum
+ * of the k smallest values in the window each take O(log n) for n ranks, so
+ * that moving the window by one pixel costs O(d log n), rather than the
+ * O(d^2 log d) of sorting the whole neighbourhood.
+ *
+ * Values are ranked once for a band of rows with rank_band(); ties are
+ * broken by position so that each pixel has a distinct rank.
+ */
+
+class order_window {
+private:
+   int n; //!< Number of ranks
+   int top; //!< Highest power of two not exceeding n
+   std::vector<int> cnt; //!< Fenwick tree of counts
+   std::vector<double> tot; //!< Fenwick tree of sums
+private:
+   void add(int r, const int c, const double x)
+      {
+      for (r++; r <= n; r += r & -r)
+         {
+         cnt[r] += c;
+         tot[r] += x;
+         }
+      }
+public:
+   //! Set up for ranks in [0,n-1], with an empty window
+   void init(const int n)
+      {
+      this->n = n;
+      for (top = 1; top * 2 <= n; top *= 2)
+         ;
+      cnt.assign(n + 1, 0);
+      tot.assign(n + 1, 0);
+      }
+   //! Add value 'x' with rank 'r' to the window
+   void insert(const int r, const double x)
+      {
+      add(r, 1, x);
+      }
+   //! Remove value 'x' with rank 'r' from the window
+   void remove(const int r, const double x)
+      {
+      add(r, -1, -x);
+      }
+   //! Sum of the 'k' smallest values in the window
+   double sum_smallest(int k) const
+      {
+      double s = 0;
+      int pos = 0;
+      for (int step = top; step > 0 && n > 0; step >>= 1)
+         if (pos + step <= n && cnt[pos + step] <= k)
+            {
+            pos += step;
+            k -= cnt[pos];
+            s += tot[pos];
+            }
+      return s;
+      }
+};
+
+/*!
+ * \brief Rank the pixels in rows [r0,r1] of an image
+ * On return, rank(i-r0,j) holds the rank of pixel (i,j) within the band.
+ * \return The number of ranks
+ */
+template <class T>
+int rank_band(const libbase::matrix<T>& in, const int r0, const int r1,
+      libbase::matrix<int>& rank)
+   {
+   const int N = in.size().cols();
+   const int n = (r1 - r0 + 1) * N;
+   std::vector<std::pair<T, int> > v(n);
+   for (int k = 0; k < n; k++)
+      v[k] = std::make_pair(in(r0 + k / N, k % N), k);
+   std::sort(v.begin(), v.end());
+   rank.init(r1 - r0 + 1, N);
+   for (int k = 0; k < n; k++)
+      rank(v[k].second / N, v[k].second % N) = k;
+   return n;
+   }
+
+} // end namespace
+
+#endif
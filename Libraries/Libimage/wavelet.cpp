@@ -21,6 +21,8 @@
 
 #include "wavelet.h"
 #include "itfunc.h"
+#include <vector>
+#include <algorithm>
 
 namespace libimage {
 
@@ -58,58 +60,198 @@ vector<double> wavelet::quadrature(const vector<double>& g)
 
  */
 
-void wavelet::partial_transform(const vector<double>& in, vector<double>& out,
-      const int n) const
+/*
+ Lifting factorizations are written in terms of the even and odd samples
+ e(i) = x(2i) and o(i) = x(2i+1), with indices taken cyclically.
+
+ Haar:
+ d(i) = o(i) - e(i)
+ s(i) = e(i) + d(i)/2
+ output s(i).sqrt(2) and -d(i)/sqrt(2)
+
+ Daub4:
+ o1(i) = o(i) - sqrt(3) e(i)
+ e1(i) = e(i) + sqrt(3)/4 o1(i) + (sqrt(3)-2)/4 o1(i+1)
+ o2(i) = o1(i) + e1(i-1)
+ output e1(i).(sqrt(3)+1)/sqrt(2) and o2(i+1).(1-sqrt(3))/sqrt(2)
+
+ Both give the same result as the filters above (up to the precision of
+ the tabulated coefficients).
+ */
+
+void wavelet::partial_transform(double* x, double* b, const int n,
+      const int lanes) const
    {
-   assert(in.size() == out.size());
-   assert(n <= in.size());
    // trap calls where n is too small
    if (n < 4)
       return;
-   // initialise workspace (since out & in may be the same vector)
-   vector<double> b(n);
-   b = 0;
    // set up some constants that we need
    const int nh = n >> 1;
-   const int mask = n - 1;
-   const int ncof = g.size();
-   // do the transform
+   const int L = lanes;
+   double* e = b;
+   double* o = b + nh * L;
+   if (lifting == lifting_none)
+      {
+      const int mask = n - 1;
+      const int ncof = g.size();
+      for (int k = 0; k < n * L; k++)
+         b[k] = 0;
+      for (int i = 0; i < nh; i++)
+         for (int j = 0; j < ncof; j++)
+            {
+            const double* xk = x + (((i << 1) + j) & mask) * L;
+            const double gj = g(j), hj = h(j);
+            double* bs = e + i * L;
+            double* bd = o + i * L;
+            for (int l = 0; l < L; l++)
+               {
+               bs[l] += gj * xk[l];
+               bd[l] += hj * xk[l];
+               }
+            }
+      for (int k = 0; k < n * L; k++)
+         x[k] = b[k];
+      return;
+      }
+   // split into even and odd samples
+   for (int i = 0; i < nh; i++)
+      for (int l = 0; l < L; l++)
+         {
+         e[i * L + l] = x[(2 * i) * L + l];
+         o[i * L + l] = x[(2 * i + 1) * L + l];
+         }
+   if (lifting == lifting_haar)
+      {
+      const double ks = sqrt(2.0), kd = -1 / sqrt(2.0);
+      for (int k = 0; k < nh * L; k++)
+         {
+         const double d = o[k] - e[k];
+         x[k] = (e[k] + d / 2) * ks;
+         x[nh * L + k] = d * kd;
+         }
+      return;
+      }
+   // Daub4
+   const double r3 = sqrt(3.0);
+   const double c1 = r3 / 4, c2 = (r3 - 2) / 4;
+   const double ks = (r3 + 1) / sqrt(2.0), kd = (1 - r3) / sqrt(2.0);
+   for (int k = 0; k < nh * L; k++)
+      o[k] -= r3 * e[k];
+   for (int i = 0; i < nh; i++)
+      {
+      double* ei = e + i * L;
+      const double* oi = o + i * L;
+      const double* on = o + ((i + 1 == nh) ? 0 : i + 1) * L;
+      for (int l = 0; l < L; l++)
+         ei[l] += c1 * oi[l] + c2 * on[l];
+      }
+   for (int i = 0; i < nh; i++)
+      {
+      double* oi = o + i * L;
+      const double* ep = e + ((i == 0) ? nh - 1 : i - 1) * L;
+      for (int l = 0; l < L; l++)
+         oi[l] += ep[l];
+      }
    for (int i = 0; i < nh; i++)
-      for (int j = 0; j < ncof; j++)
+      {
+      const double* ei = e + i * L;
+      const double* on = o + ((i + 1 == nh) ? 0 : i + 1) * L;
+      double* xs = x + i * L;
+      double* xd = x + (nh + i) * L;
+      for (int l = 0; l < L; l++)
          {
-         const int k = ((i << 1) + j) & mask;
-         b(i) += g(j) * in(k);
-         b(i + nh) += h(j) * in(k);
+         xs[l] = ei[l] * ks;
+         xd[l] = on[l] * kd;
          }
-   // copy the result back from workspace
-   out.copyfrom(b);
+      }
    }
 
-void wavelet::partial_inverse(const vector<double>& in, vector<double>& out,
-      const int n) const
+void wavelet::partial_inverse(double* x, double* b, const int n,
+      const int lanes) const
    {
-   assert(in.size() == out.size());
-   assert(n <= in.size());
    // trap calls where n is too small
    if (n < 4)
       return;
-   // initialise workspace (since out & in may be the same vector)
-   vector<double> b(n);
-   b = 0;
    // set up some constants that we need
    const int nh = n >> 1;
-   const int mask = n - 1;
-   const int ncof = g.size();
-   // do the transform
+   const int L = lanes;
+   double* e = b;
+   double* o = b + nh * L;
+   if (lifting == lifting_none)
+      {
+      const int mask = n - 1;
+      const int ncof = g.size();
+      for (int k = 0; k < n * L; k++)
+         b[k] = 0;
+      for (int i = 0; i < nh; i++)
+         for (int j = 0; j < ncof; j++)
+            {
+            double* bk = b + (((i << 1) + j) & mask) * L;
+            const double gj = g(j), hj = h(j);
+            const double* xs = x + i * L;
+            const double* xd = x + (i + nh) * L;
+            for (int l = 0; l < L; l++)
+               bk[l] += gj * xs[l] + hj * xd[l];
+            }
+      for (int k = 0; k < n * L; k++)
+         x[k] = b[k];
+      return;
+      }
+   if (lifting == lifting_haar)
+      {
+      const double ks = sqrt(2.0), kd = -1 / sqrt(2.0);
+      for (int k = 0; k < nh * L; k++)
+         {
+         const double d = x[nh * L + k] / kd;
+         e[k] = x[k] / ks - d / 2;
+         o[k] = d + e[k];
+         }
+      }
+   else
+      {
+      // Daub4
+      const double r3 = sqrt(3.0);
+      const double c1 = r3 / 4, c2 = (r3 - 2) / 4;
+      const double ks = (r3 + 1) / sqrt(2.0), kd = (1 - r3) / sqrt(2.0);
+      for (int i = 0; i < nh; i++)
+         {
+         const double* xs = x + i * L;
+         const double* xd = x + (nh + i) * L;
+         double* ei = e + i * L;
+         double* on = o + ((i + 1 == nh) ? 0 : i + 1) * L;
+         for (int l = 0; l < L; l++)
+            {
+            ei[l] = xs[l] / ks;
+            on[l] = xd[l] / kd;
+            }
+         }
+      for (int i = 0; i < nh; i++)
+         {
+         double* oi = o + i * L;
+         const double* ep = e + ((i == 0) ? nh - 1 : i - 1) * L;
+         for (int l = 0; l < L; l++)
+            oi[l] -= ep[l];
+         }
+      for (int i = 0; i < nh; i++)
+         {
+         double* ei = e + i * L;
+         const double* oi = o + i * L;
+         const double* on = o + ((i + 1 == nh) ? 0 : i + 1) * L;
+         for (int l = 0; l < L; l++)
+            ei[l] -= c1 * oi[l] + c2 * on[l];
+         }
+      for (int k = 0; k < nh * L; k++)
+         o[k] += r3 * e[k];
+      }
+   // merge even and odd samples
    for (int i = 0; i < nh; i++)
-      for (int j = 0; j < ncof; j++)
+      for (int l = 0; l < L; l++)
          {
-         const int k = ((i << 1) + j) & mask;
-         b(k) += g(j) * in(i) + h(j) * in(i + nh);
+         x[(2 * i) * L + l] = e[i * L + l];
+         x[(2 * i + 1) * L + l] = o[i * L + l];
          }
-   // copy the result back from workspace
-   out.copyfrom(b);
    }
+
 /*
  void wavelet::partial_titransform(vector<double>& a, vector<double>& hsr, vector<double>& hsl, vector<double>& lsr, vector<double>& lsl) const
  {
@@ -489,6 +631,13 @@ void wavelet::init(const int type, const int par)
    // normalise g and create quadrature filter
    g /= sqrt(g.sumsq());
    h = quadrature(g);
+   // use a lifting factorization where one is available
+   if (type == 0)
+      lifting = lifting_haar;
+   else if (type == 3 && par == 4)
+      lifting = lifting_daub4;
+   else
+      lifting = lifting_none;
    // debug information
    libbase::trace << "wavelet initialised - type (" << type << ") par (" << par
          << ")." << std::endl;
@@ -505,30 +654,90 @@ int wavelet::getlimit(const int size, const int level) const
    return std::max(2, size >> level);
    }
 
+// transform / inverse functions - interleaved sequences
+
+void wavelet::transform(double* x, double* b, const int size, const int lanes,
+      const int level) const
+   {
+   // start at the largest heirarchy and work towards the smallest
+   const int limit = getlimit(size, level) << 1;
+   for (int n = size; n >= limit; n >>= 1)
+      partial_transform(x, b, n, lanes);
+   }
+
+void wavelet::inverse(double* x, double* b, const int size, const int lanes,
+      const int level) const
+   {
+   // start at the smallest heirarchy and work towards the largest
+   const int limit = getlimit(size, level) << 1;
+   for (int n = limit; n <= size; n <<= 1)
+      partial_inverse(x, b, n, lanes);
+   }
+
+/*!
+ * \brief Transform rows, then columns, of a matrix in place
+ * Rows are transformed directly; columns are copied in blocks of adjacent
+ * columns into an interleaved buffer, so that each step of the transform
+ * works along contiguous memory for all columns in the block.
+ */
+void wavelet::apply(matrix<double>& x, const int level, const bool forward) const
+   {
+   const int M = x.size().rows();
+   const int N = x.size().cols();
+   const int blocks = (N + block - 1) / block;
+#pragma omp parallel
+      {
+      std::vector<double> b(std::max(N, M * block));
+      std::vector<double> c(M * block);
+#pragma omp for schedule(dynamic)
+      for (int i = 0; i < M; i++)
+         if (forward)
+            transform(&x(i, 0), &b[0], N, 1, level);
+         else
+            inverse(&x(i, 0), &b[0], N, 1, level);
+#pragma omp for schedule(dynamic)
+      for (int k = 0; k < blocks; k++)
+         {
+         const int j0 = k * block;
+         const int L = std::min(block, N - j0);
+         for (int i = 0; i < M; i++)
+            for (int l = 0; l < L; l++)
+               c[i * L + l] = x(i, j0 + l);
+         if (forward)
+            transform(&c[0], &b[0], M, L, level);
+         else
+            inverse(&c[0], &b[0], M, L, level);
+         for (int i = 0; i < M; i++)
+            for (int l = 0; l < L; l++)
+               x(i, j0 + l) = c[i * L + l];
+         }
+      }
+   }
+
 // transform / inverse functions - vector
 
 void wavelet::transform(const vector<double>& in, vector<double>& out,
       const int level) const
    {
    assert(libbase::weight(in.size()) == 1);
-   // resize the output vector if necessary
-   out.init(in.size());
-   // start at the largest heirarchy and work towards the smallest
-   const int limit = getlimit(in.size(), level) << 1;
-   for (int n = in.size(); n >= limit; n >>= 1)
-      partial_transform(in, out, n);
+   // copy to the output vector, and transform in place
+   if (&out != &in)
+      out = in;
+   std::vector<double> b(out.size());
+   if (out.size() > 0)
+      transform(&out(0), &b[0], out.size(), 1, level);
    }
 
 void wavelet::inverse(const vector<double>& in, vector<double>& out,
       const int level) const
    {
    assert(libbase::weight(in.size()) == 1);
-   // resize the output vector if necessary
-   out.init(in.size());
-   // start at the smallest heirarchy and work towards the largest
-   const int limit = getlimit(in.size(), level) << 1;
-   for (int n = limit; n <= in.size(); n <<= 1)
-      partial_inverse(in, out, n);
+   // copy to the output vector, and invert in place
+   if (&out != &in)
+      out = in;
+   std::vector<double> b(out.size());
+   if (out.size() > 0)
+      inverse(&out(0), &b[0], out.size(), 1, level);
    }
 
 // transform / inverse functions - matrix
@@ -537,48 +746,20 @@ void wavelet::transform(const matrix<double>& in, matrix<double>& out,
       const int level) const
    {
    assert(libbase::weight(in.size().rows()) == 1 && libbase::weight(in.size().cols()) == 1);
-   // resize the output matrix if necessary
-   out.init(in.size());
-   // loop variables
-   int i;
-   // do the transform for each dimension
-   vector<double> b;
-   for (i = 0; i < in.size().rows(); i++)
-      {
-      in.extractrow(b, i);
-      transform(b, b, level);
-      out.insertrow(b, i);
-      }
-   for (i = 0; i < in.size().cols(); i++)
-      {
-      out.extractcol(b, i);
-      transform(b, b, level);
-      out.insertcol(b, i);
-      }
+   // copy to the output matrix, and transform in place
+   if (&out != &in)
+      out = in;
+   apply(out, level, true);
    }
 
 void wavelet::inverse(const matrix<double>& in, matrix<double>& out,
       const int level) const
    {
    assert(libbase::weight(in.size().rows()) == 1 && libbase::weight(in.size().cols()) == 1);
-   // resize the output matrix if necessary
-   out.init(in.size());
-   // loop variables
-   int i;
-   // do the transform for each dimension
-   vector<double> b;
-   for (i = 0; i < in.size().rows(); i++)
-      {
-      in.extractrow(b, i);
-      inverse(b, b, level);
-      out.insertrow(b, i);
-      }
-   for (i = 0; i < in.size().cols(); i++)
-      {
-      out.extractcol(b, i);
-      inverse(b, b, level);
-      out.insertcol(b, i);
-      }
+   // copy to the output matrix, and invert in place
+   if (&out != &in)
+      out = in;
+   apply(out, level, false);
    }
 
 } // end namespace
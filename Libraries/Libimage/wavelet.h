@@ -66,6 +66,16 @@
  Version 1.40 (10 Nov 2006)
  * defined class and associated data within "libimage" namespace.
  * removed use of "using namespace std", replacing by tighter "using" statements as needed.
+
+ Version 1.50
+ * partial transforms now work in place on several interleaved sequences
+ ('lanes') at once, so that matrix columns are transformed in blocks of
+ adjacent columns straight from memory, without extracting each column.
+ * Haar and 4-coefficient Daubechies wavelets use a lifting-scheme
+ factorization; other filters use direct convolution.
+ * rows and column blocks of a matrix are transformed in parallel.
+ * vector transforms with distinct input and output now use the output of
+ each level as the input to the next.
  */
 
 namespace libimage {
@@ -74,18 +84,32 @@ class wavelet {
 protected:
    // the quadrature mirror filters
    libbase::vector<double> g, h;
+   // lifting factorization used, if any
+   enum {
+      lifting_none = 0, lifting_haar, lifting_daub4
+   } lifting;
+   // number of adjacent matrix columns transformed together
+   static const int block = 8;
 protected:
    // from the [smoothing] filter 'g' generate the quadrature [detail] filter 'h'
    static libbase::vector<double> quadrature(const libbase::vector<double>& g);
-   // partial forward and inverse transforms
-   void partial_transform(const libbase::vector<double>& in, libbase::vector<
-         double>& out, const int n) const;
-   void partial_inverse(const libbase::vector<double>& in, libbase::vector<
-         double>& out, const int n) const;
+   // partial forward and inverse transforms, in place on the first n
+   // elements of 'lanes' interleaved sequences, using workspace 'b'
+   void partial_transform(double* x, double* b, const int n,
+         const int lanes) const;
+   void partial_inverse(double* x, double* b, const int n, const int lanes) const;
+   // complete transforms of interleaved sequences of length 'size'
+   void transform(double* x, double* b, const int size, const int lanes,
+         const int level) const;
+   void inverse(double* x, double* b, const int size, const int lanes,
+         const int level) const;
+   // transform rows and columns of a matrix in place
+   void apply(libbase::matrix<double>& x, const int level, const bool forward) const;
    // partial translation-invariant transforms
    //void partial_titransform(vector<double>& a, vector<double>& hsr, vector<double>& hsl, vector<double>& lsr, vector<double>& lsl) const;
 public:
-   wavelet()
+   wavelet() :
+      lifting(lifting_none)
       {
       }
    wavelet(const int type, const int par = 0)
@@ -25,10 +25,16 @@
 #include "commsys_stream.h"
 #include "channel_stream.h"
 #include "codec/codec_softout.h"
+#include "binaryframe.h"
+#include "frame_pool.h"
 #include "cputimer.h"
+#include "walltimer.h"
 
 #include <boost/program_options.hpp>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <limits>
 #include <list>
 
 namespace csdecode {
@@ -102,18 +108,77 @@ void readnextblock(std::istream& sin, C<S>& result,
    result.serialize(sin);
    }
 
-// block read and receive methods
+// block reading from binary frames
+
+template <class S>
+void read(libcomm::binaryframe_reader& reader, libbase::vector<S>& result,
+      const libbase::size_type<libbase::vector>& blocksize)
+   {
+   reader.read_symbols(result, blocksize);
+   std::cerr << "Read block of length = " << result.size() << std::endl;
+   }
+
+template <class S>
+void readsingleblock(libcomm::binaryframe_reader& reader,
+      libbase::vector<S>& result,
+      const libbase::size_type<libbase::vector>& blocksize)
+   {
+   // read all remaining symbols, up to the block size if given
+   const int n = (blocksize > 0) ? int(blocksize)
+         : std::numeric_limits<int>::max();
+   reader.read_symbols(result, n);
+   std::cerr << "Read block of length = " << result.size() << std::endl;
+   }
+
+template <class S>
+void readsingleblock(libcomm::binaryframe_reader& reader,
+      libbase::matrix<S>& result,
+      const libbase::size_type<libbase::matrix>& blocksize)
+   {
+   failwith("not implemented");
+   }
 
 template <class S, template <class > class C>
-void receiver_soft_single(std::istream& sin,
+void readnextblock(libcomm::binaryframe_reader& reader, C<S>& result,
+      const libbase::size_type<C>& blocksize)
+   {
+   assertalways(reader.read(result));
+   assertalways(result.size() == blocksize);
+   }
+
+// input stream handling
+
+inline void skipwhite(std::istream& sin)
+   {
+   libbase::eatwhite(sin);
+   }
+
+inline void skipwhite(libcomm::binaryframe_reader& reader)
+   {
+   }
+
+inline bool at_end(std::istream& sin)
+   {
+   return sin.eof();
+   }
+
+inline bool at_end(libcomm::binaryframe_reader& reader)
+   {
+   return reader.eof();
+   }
+
+// block read and receive methods
+
+template <class S, template <class > class C, class I>
+void receiver_soft_single(I& sin,
       boost::shared_ptr<libcomm::commsys<S, C> > system,
       const libbase::size_type<C>& blocksize)
    {
    failwith("Not supported.");
    }
 
-template <class S, template <class > class C>
-void receiver_soft_multi(std::istream& sin,
+template <class S, template <class > class C, class I>
+void receiver_soft_multi(I& sin,
       boost::shared_ptr<libcomm::commsys<S, C> > system,
       const libbase::size_type<C>& blocksize)
    {
@@ -123,8 +188,8 @@ void receiver_soft_multi(std::istream& sin,
    system->softreceive_path(ptable_in);
    }
 
-template <class S, template <class > class C>
-void receiver_single(std::istream& sin,
+template <class S, template <class > class C, class I>
+void receiver_single(I& sin,
       boost::shared_ptr<libcomm::commsys<S, C> > system,
       const libbase::size_type<C>& blocksize)
    {
@@ -133,8 +198,8 @@ void receiver_single(std::istream& sin,
    system->receive_path(received);
    }
 
-template <class S, template <class > class C>
-void receiver_multi(std::istream& sin,
+template <class S, template <class > class C, class I>
+void receiver_multi(I& sin,
       boost::shared_ptr<libcomm::commsys<S, C> > system,
       const libbase::size_type<C>& blocksize)
    {
@@ -143,98 +208,23 @@ void receiver_multi(std::istream& sin,
    system->receive_path(received);
    }
 
-//template <class S, template <class > class C>
-//void receiver_multi_stream(std::istream& sin,
-//      libcomm::commsys_stream<S, C>* system,
-//      const libbase::size_type<C>& blocksize)
-
-template <class S>
-void receiver_multi_stream(std::istream& sin,
-      boost::shared_ptr<libcomm::commsys_stream<S, libbase::vector, float> > system,
-      const libbase::size_type<libbase::vector>& blocksize)
-   {
-   // Keep posterior probabilities at end-of-frame and computed drift
-   static libbase::vector<double> eof_post;
-   static libbase::size_type<libbase::vector> offset;
-   static libbase::size_type<libbase::vector> estimated_drift;
-   // Keep received sequence
-   static libbase::vector<S> received;
-
-   // Shorthand for transmitted frame size
-   const int tau = system->output_block_size();
-
-   // Keep a copy of the last frame's offset (in case state space changes)
-   const libbase::size_type<libbase::vector> oldoffset = offset;
-
-   // Determine the suggested look-ahead quantity
-   const libbase::size_type<libbase::vector> lookahead =
-         system->getmodem_stream().get_suggested_lookahead();
-   // Determine start-of-frame and end-of-frame probabilities
-   libbase::vector<double> sof_prior;
-   libbase::vector<double> eof_prior;
-   system->compute_priors(eof_post, lookahead, sof_prior, eof_prior, offset);
-
-   // Extract required segment of existing stream
-   system->stream_advance(received, oldoffset, estimated_drift, offset);
-   // Determine required segment size
-   const int length = tau + lookahead + eof_prior.size() - 1
-         - received.size();
-#ifndef NDEBUG
-   std::cerr << "DEBUG: this segment = " << length << std::endl;
-#endif
-   // Read required segment from file
-   libbase::vector<S> received_next;
-   read(sin, received_next, libbase::size_type<libbase::vector>(length));
-   // Assemble received sequence
-   received = concatenate(received, received_next);
-   // Stop here if the received sequence is too short
-   if (received.size() < tau)
-      {
-      std::cerr << "Received sequence too short, stopping here." << std::endl;
-      exit(1);
-      }
-   // Handle short received sequences
-   else if (received.size() < tau + eof_prior.size() - 1)
-      {
-      libbase::vector<S> padding;
-      padding.init(tau + eof_prior.size() - 1 - received.size());
-      padding = 0; // value is irrelevant as this is not used
-      received = concatenate(received, padding);
-      const int start = eof_prior.size() - padding.size() - 1;
-      const int n = padding.size();
-      eof_prior.segment(start, n) = 0;
-#ifndef NDEBUG
-      std::cerr << "DEBUG: padding size = " << padding.size() << std::endl;
-      std::cerr << "DEBUG: eof_prior = " << eof_prior << std::endl;
-#endif
-      }
-
-   // Demodulate -> Inverse Map -> Translate
-   system->receive_path(received, lookahead, sof_prior, eof_prior, offset);
-   // Store posterior end-of-frame drift probabilities
-   eof_post = system->get_eof_post();
-
-   // Determine estimated drift
-   estimated_drift = libcomm::commsys_stream<S, libbase::vector, float>::estimate_drift(eof_post,
-         offset);
-   // Centralize posterior probabilities
-   eof_post = libcomm::commsys_stream<S, libbase::vector, float>::centralize_pdf(eof_post,
-         estimated_drift);
-   }
-
-template <class S>
-void receiver_multi_stream(std::istream& sin,
-      boost::shared_ptr<libcomm::commsys_stream<S, libbase::matrix, float> > system,
-      const libbase::size_type<libbase::matrix>& blocksize)
-   {
-   failwith("Not implemented.");
-   }
-
 // results output methods
 
+/*!
+ * \brief   Output format
+ *
+ * Results are written as text, or as binary frames with the given payload
+ * type for soft output.
+ */
+struct output_format {
+   bool binary;
+   libcomm::binaryframe::payload_t payload;
+};
+
 template <class S, template <class > class C>
 void decode_soft(std::ostream& sout,
-      boost::shared_ptr<libcomm::commsys<S, C> > system)
+      boost::shared_ptr<libcomm::commsys<S, C> > system,
+      const output_format& format)
    {
    typedef libbase::vector<double> array1d_t;
    typedef libcomm::codec_softout<C> codec_so;
@@ -242,54 +232,286 @@ void decode_soft(std::ostream& sout,
    C<array1d_t> ptable_out;
    for (int i = 0; i < system->num_iter(); i++)
       cdc.softdecode(ptable_out);
-   ptable_out.serialize(sout);
+   if (format.binary)
+      libcomm::binaryframe_writer(sout, format.payload).write(ptable_out);
+   else
+      ptable_out.serialize(sout);
    }
 
 template <class S, template <class > class C>
 void decode(std::ostream& sout,
-      boost::shared_ptr<libcomm::commsys<S, C> > system)
+      boost::shared_ptr<libcomm::commsys<S, C> > system,
+      const output_format& format)
    {
    C<int> decoded;
    for (int i = 0; i < system->num_iter(); i++)
       system->decode(decoded);
-   decoded.serialize(sout, '\n');
+   if (format.binary)
+      libcomm::binaryframe_writer(sout).write(decoded);
+   else
+      decoded.serialize(sout, '\n');
    }
 
-/*!
- * \brief   Main process
- *
- * Reads the supplied system from file, and decodes from given input to
- * output stream.
- */
+// system setup
 
 template <class S, template <class > class C>
-void process(const std::string& fname, double p, bool softin, bool softout,
-      bool knownend, int count, libbase::size_type<C>& blocksize,
-      std::istream& sin = std::cin, std::ostream& sout = std::cout)
+boost::shared_ptr<libcomm::commsys<S, C> > load_system(
+      const std::string& fname, double p)
    {
-   // define types
-   typedef libcomm::commsys<S, C> commsys;
-   typedef libcomm::commsys_stream<S, C, float> commsys_stream;
-
    // Communication system
-   boost::shared_ptr<commsys> system = libcomm::loadfromfile<commsys>(fname);
-   std::cerr << system->description() << std::endl;
+   boost::shared_ptr<libcomm::commsys<S, C> > system = libcomm::loadfromfile<
+         libcomm::commsys<S, C> >(fname);
    // Set channel parameter
    system->getrxchan()->set_parameter(p);
    // Initialize system
    libbase::randgen r;
    r.seed(0);
    system->seedfrom(r);
-   // Determine block size to use if necessary
-   if (!knownend && blocksize == 0)
-      blocksize = system->output_block_size();
-   // Check if this is a stream-oriented system
-   boost::shared_ptr<commsys_stream> system_stream = boost::dynamic_pointer_cast<
-         commsys_stream>(system);
+   return system;
+   }
+
+// frame-by-frame receiving
+
+template <class S, template <class > class C>
+void receive_frame(libcomm::commsys<S, C>& system, const C<S>& received)
+   {
+   system.receive_path(received);
+   }
+
+template <class S, template <class > class C>
+void receive_frame(libcomm::commsys<S, C>& system,
+      const C<libbase::vector<double> >& ptable_in)
+   {
+   system.softreceive_path(ptable_in);
+   }
+
+// stream decoding
+
+/*!
+ * \brief   Stream receiver
+ *
+ * Receives consecutive frames from a continuous stream, keeping the state
+ * that links each frame to the next: a sliding window over the received
+ * sequence, and the end-of-frame posterior drift probabilities with the
+ * drift estimated from them, which give the priors for the next frame.
+ *
+ * Each frame is handled in two steps: read_frame() completes the window
+ * for the next frame, and receive() passes it through the receiver. Since
+ * the expected amount of input per frame is known, the next frame's input
+ * can be read ahead with read_ahead() while the current frame is received
+ * and decoded.
+ */
+
+template <class S, template <class > class C>
+class stream_receiver {
+public:
+   stream_receiver(
+         boost::shared_ptr<libcomm::commsys_stream<S, C, float> > system)
+      {
+      failwith("Not implemented.");
+      }
+   template <class I>
+   void read_frame(I& sin)
+      {
+      }
+   template <class I>
+   void read_ahead(I& sin)
+      {
+      }
+   void receive()
+      {
+      }
+   template <class I>
+   bool at_end(I& sin) const
+      {
+      return true;
+      }
+};
+
+template <class S>
+class stream_receiver<S, libbase::vector> {
+private:
+   typedef libcomm::commsys_stream<S, libbase::vector, float> commsys_stream;
+   typedef libbase::size_type<libbase::vector> size_type;
+private:
+   boost::shared_ptr<commsys_stream> system;
+   //! Window over received sequence, starting at current frame
+   libbase::circular_buffer<S> received;
+   //! Symbols read ahead, following the window
+   libbase::circular_buffer<S> ahead;
+   //! Posterior probabilities at end of last frame
+   libbase::vector<double> eof_post;
+   //! Offset of posterior probabilities
+   size_type offset;
+   //! Drift estimated at end of last frame
+   size_type estimated_drift;
+   /*! 
+ame Priors for current frame */
+   size_type lookahead;
+   libbase::vector<double> sof_prior;
+   libbase::vector<double> eof_prior;
+   // @}
+public:
+   explicit stream_receiver(boost::shared_ptr<commsys_stream> system) :
+      system(system)
+      {
+      }
+   //! Complete the window for the next frame, using input read ahead first
+   template <class I>
+   void read_frame(I& sin)
+      {
+      // Shorthand for transmitted frame size
+      const int tau = system->output_block_size();
+      // Keep a copy of the last frame's offset (in case state space changes)
+      const size_type oldoffset = offset;
+      // Determine the suggested look-ahead quantity
+      lookahead = system->getmodem_stream().get_suggested_lookahead();
+      // Determine start-of-frame and end-of-frame probabilities
+      system->compute_priors(eof_post, lookahead, sof_prior, eof_prior,
+            offset);
+      // Slide window to start of this frame
+      system->stream_advance(received, oldoffset, estimated_drift, offset);
+      // Determine required segment size
+      int length = tau + lookahead + eof_prior.size() - 1 - received.size();
+#ifndef NDEBUG
+      std::cerr << "DEBUG: this segment = " << length << std::endl;
+#endif
+      // Take what we can from input read ahead
+      const int n = std::min(std::max(length, 0), ahead.size());
+      received.push_back(libbase::vector<S>(ahead.segment(0, n)));
+      ahead.pop_front(n);
+      length -= n;
+      // Read the rest of the segment from input
+      if (length > 0)
+         {
+         libbase::vector<S> received_next;
+         read(sin, received_next, size_type(length));
+         skipwhite(sin);
+         received.push_back(received_next);
+         }
+      // Stop here if the received sequence is too short
+      if (received.size() < tau)
+         {
+         std::cerr << "Received sequence too short, stopping here."
+               << std::endl;
+         exit(1);
+         }
+      // Handle short received sequences
+      else if (received.size() < tau + eof_prior.size() - 1)
+         {
+         const int n = tau + eof_prior.size() - 1 - received.size();
+         received.push_back(n, S(0)); // value is irrelevant as this is not used
+         const int start = eof_prior.size() - n - 1;
+         eof_prior.segment(start, n) = 0;
+#ifndef NDEBUG
+         std::cerr << "DEBUG: padding size = " << n << std::endl;
+         std::cerr << "DEBUG: eof_prior = " << eof_prior << std::endl;
+#endif
+         }
+      }
+   //! Read ahead the input expected for one frame
+   template <class I>
+   void read_ahead(I& sin)
+      {
+      if (ahead.size() > 0 || at_end(sin))
+         return;
+      libbase::vector<S> received_next;
+      read(sin, received_next, size_type(system->output_block_size()));
+      skipwhite(sin);
+      ahead.push_back(received_next);
+      }
+   //! Pass the current frame through the receiver
+   void receive()
+      {
+      // Demodulate -> Inverse Map -> Translate
+      system->receive_path(received.segment(0, received.size()), lookahead,
+            sof_prior, eof_prior, offset);
+      // Store posterior end-of-frame drift probabilities
+      eof_post = system->get_eof_post();
+      // Determine estimated drift
+      estimated_drift = commsys_stream::estimate_drift(eof_post, offset);
+      // Centralize posterior probabilities
+      eof_post = commsys_stream::centralize_pdf(eof_post, estimated_drift);
+      }
+   //! Whether all input has been used
+   template <class I>
+   bool at_end(I& sin) const
+      {
+      return ahead.size() == 0 && csdecode::at_end(sin);
+      }
+};
+
+/*!
+ * \brief   Stream decoding
+ *
+ * Frames are received and decoded one after the other, as each depends on
+ * the end-of-frame state of the last one. Reading the input for the next
+ * frame is overlapped with receiving and decoding the current one.
+ *
+ * \note Nested parallelism must be enabled (e.g. by setting
+ * OMP_MAX_ACTIVE_LEVELS) for the receiver's own parallel kernels to use
+ * more than one thread while input is being read ahead; the overlap can be
+ * turned off otherwise.
+ *
+ * \return The number of frames decoded
+ */
 
+template <class S, template <class > class C, class I>
+int decode_stream(I& sin,
+      boost::shared_ptr<libcomm::commsys_stream<S, C, float> > system,
+      bool softout, int count, bool overlap, const output_format& format,
+      std::ostream& sout)
+   {
+   stream_receiver<S, C> receiver(system);
+   int i = 0;
+   for (bool ready = false; !ready;)
+      {
+      receiver.read_frame(sin);
+#pragma omp parallel sections num_threads(2) if(overlap)
+         {
+#pragma omp section
+            {
+            // receive, decode and output result
+            receiver.receive();
+            if (softout)
+               decode_soft<S, C> (sout, system, format);
+            else
+               decode<S, C> (sout, system, format);
+            }
+#pragma omp section
+            {
+            // read input for the next frame
+            if (count <= 0 || i + 1 < count)
+               receiver.read_ahead(sin);
+            }
+         }
+      // loop advance
+      i++;
+      ready = (count > 0) ? (i >= count) : receiver.at_end(sin);
+      }
+   return i;
+   }
+
+// decoding loops
+
+/*!
+ * \brief   Serial decoding
+ *
+ * Reads each frame and passes it through the receiver, then decodes and
+ * outputs the result, one frame at a time.
+ *
+ * \return The number of frames decoded
+ */
+
+template <class S, template <class > class C, class I>
+int decode_serial(I& sin, boost::shared_ptr<libcomm::commsys<S, C> > system,
+      bool softin, bool softout, bool knownend, int count,
+      const libbase::size_type<C>& blocksize, const output_format& format,
+      std::ostream& sout)
+   {
    // Repeat until required number of blocks read or end of stream
-   bool ready = false;
-   for (int i = 0; !ready;)
+   int i = 0;
+   for (bool ready = false; !ready;)
       {
       // read next frame and pass through receiver
       if (softin)
@@ -304,23 +526,190 @@ void process(const std::string& fname, double p, bool softin, bool softout,
          if (knownend)
             receiver_single(sin, system, blocksize);
          else
-            {
-            if (system_stream)
-               receiver_multi_stream(sin, system_stream, blocksize);
-            else
-               receiver_multi(sin, system, blocksize);
-            }
+            receiver_multi(sin, system, blocksize);
          }
-      libbase::eatwhite(sin);
+      skipwhite(sin);
       // decode and output result
       if (softout)
-         decode_soft(sout, system);
+         decode_soft(sout, system, format);
       else
-         decode(sout, system);
+         decode(sout, system, format);
       // loop advance
       i++;
-      ready = (count > 0) ? (i >= count) : sin.eof();
+      ready = (count > 0) ? (i >= count) : at_end(sin);
+      }
+   return i;
+   }
+
+/*!
+ * \brief   Parallel decoding job
+ *
+ * Reads independent frames from the input, and decodes each one with the
+ * calling thread's copy of the system, for use with a libbase::frame_pool.
+ *
+ * Before decoding, the system is seeded from the frame index, so that
+ * results do not depend on which thread decodes which frame; the first
+ * frame is seeded in the same way as for serial decoding.
+ */
+
+template <class F, class S, template <class > class C, class I>
+class decode_job {
+private:
+   I& sin;
+   std::vector<boost::shared_ptr<libcomm::commsys<S, C> > >& systems;
+   const bool softout;
+   const int count;
+   const libbase::size_type<C> blocksize;
+   const output_format format;
+   int frames;
+public:
+   decode_job(I& sin,
+         std::vector<boost::shared_ptr<libcomm::commsys<S, C> > >& systems,
+         bool softout, int count, const libbase::size_type<C>& blocksize,
+         const output_format& format) :
+      sin(sin), systems(systems), softout(softout), count(count),
+            blocksize(blocksize), format(format), frames(0)
+      {
+      }
+   bool read(F& frame)
+      {
+      skipwhite(sin);
+      if ((count > 0) ? (frames >= count) : at_end(sin))
+         return false;
+      readnextblock(sin, frame, blocksize);
+      frames++;
+      return true;
+      }
+   void process(const int thread, const int index, const F& frame,
+         std::string& result)
+      {
+      boost::shared_ptr<libcomm::commsys<S, C> > system = systems[thread];
+      libbase::randgen r;
+      r.seed(index);
+      system->seedfrom(r);
+      receive_frame(*system, frame);
+      std::ostringstream s;
+      if (softout)
+         decode_soft(s, system, format);
+      else
+         decode(s, system, format);
+      result = s.str();
+      }
+};
+
+/*!
+ * \brief   Parallel decoding
+ *
+ * Frames are decoded by a pool of workers, each with its own copy of the
+ * system, and results are written in input order.
+ */
+
+template <class F, class S, template <class > class C, class I>
+int decode_parallel(I& sin,
+      std::vector<boost::shared_ptr<libcomm::commsys<S, C> > >& systems,
+      bool softout, int count, const libbase::size_type<C>& blocksize,
+      const output_format& format, int depth, std::ostream& sout)
+   {
+   decode_job<F, S, C, I> job(sin, systems, softout, count, blocksize, format);
+   libbase::frame_pool<F, decode_job<F, S, C, I> > pool(systems.size(), depth);
+   pool.run(job, sout);
+   return pool.get_frames();
+   }
+
+/*!
+ * \brief   Decoding with any input
+ *
+ * Independent frames are decoded in parallel when more than one worker is
+ * requested; stream-oriented systems and single-block input are always
+ * decoded serially, since frames depend on each other. Stream-oriented
+ * systems with hard input are decoded with a stream receiver.
+ *
+ * \return The number of frames decoded
+ */
+
+template <class S, template <class > class C, class I>
+int decode_input(I& sin, const std::string& fname, double p,
+      boost::shared_ptr<libcomm::commsys<S, C> > system, bool softin,
+      bool softout, bool knownend, int count,
+      const libbase::size_type<C>& blocksize, const output_format& format,
+      int workers, int depth, bool overlap, std::ostream& sout)
+   {
+   // define types
+   typedef libcomm::commsys<S, C> commsys;
+   typedef libcomm::commsys_stream<S, C, float> commsys_stream;
+   typedef libbase::vector<double> array1d_t;
+
+   // Check if this is a stream-oriented system
+   boost::shared_ptr<commsys_stream> system_stream = boost::dynamic_pointer_cast<
+         commsys_stream>(system);
+   if (system_stream && !softin && !knownend)
+      return decode_stream(sin, system_stream, softout, count, overlap, format,
+            sout);
+   if (knownend || system_stream || workers == 1)
+      return decode_serial(sin, system, softin, softout, knownend, count,
+            blocksize, format, sout);
+   // Set up a copy of the system for each worker
+   std::cerr << "Decoding with " << workers << " workers" << std::endl;
+   std::vector<boost::shared_ptr<commsys> > systems(workers);
+   systems[0] = system;
+   for (int t = 1; t < workers; t++)
+      systems[t] = load_system<S, C> (fname, p);
+   if (softin)
+      return decode_parallel<C<array1d_t> > (sin, systems, softout, count,
+            blocksize, format, depth, sout);
+   return decode_parallel<C<S> > (sin, systems, softout, count, blocksize,
+         format, depth, sout);
+   }
+
+/*!
+ * \brief   Main process
+ *
+ * Reads the supplied system from file, and decodes from given input to
+ * output stream. Input is read from the named file if given, and from the
+ * standard input otherwise.
+ */
+
+template <class S, template <class > class C>
+void process(const std::string& fname, double p, bool softin, bool softout,
+      bool knownend, int count, libbase::size_type<C>& blocksize,
+      const std::string& infile, bool binaryin, const output_format& format,
+      int workers, int depth, bool overlap, std::istream& sin = std::cin,
+      std::ostream& sout = std::cout)
+   {
+   // Communication system
+   boost::shared_ptr<libcomm::commsys<S, C> > system = load_system<S, C> (
+         fname, p);
+   std::cerr << system->description() << std::endl;
+   // Determine block size to use if necessary
+   if (!knownend && blocksize == 0)
+      blocksize = system->output_block_size();
+
+   libbase::walltimer t("Decoding");
+   int frames;
+   if (binaryin)
+      {
+      boost::shared_ptr<libcomm::binaryframe_reader> reader(infile.empty()
+            ? new libcomm::binaryframe_reader(sin)
+            : new libcomm::binaryframe_reader(infile));
+      frames = decode_input(*reader, fname, p, system, softin, softout,
+            knownend, count, blocksize, format, workers, depth, overlap, sout);
+      }
+   else if (infile.empty())
+      frames = decode_input(sin, fname, p, system, softin, softout, knownend,
+            count, blocksize, format, workers, depth, overlap, sout);
+   else
+      {
+      std::ifstream file(infile.c_str());
+      assertalways(file);
+      frames = decode_input(file, fname, p, system, softin, softout,
+            knownend, count, blocksize, format, workers, depth, overlap, sout);
       }
+   t.stop();
+   // Report throughput
+   std::cerr << "Decoded " << frames << " frames in " << t;
+   if (t.elapsed() > 0)
+      std::cerr << " (" << frames / t.elapsed() << " frames/s)";
+   std::cerr << std::endl;
    }
 
 /*!
@@ -356,6 +745,20 @@ int main(int argc, char *argv[])
          "row size to read for matrix container (default: tx size)");
    desc.add_options()("col-size", po::value<int>(),
          "column size to read for matrix container (default: tx size)");
+   desc.add_options()("input-file,f", po::value<std::string>(),
+         "read input from file (default: standard input)");
+   desc.add_options()("binary-in", po::bool_switch(),
+         "read input as binary frames");
+   desc.add_options()("binary-out", po::bool_switch(),
+         "write output as binary frames");
+   desc.add_options()("payload", po::value<std::string>()->default_value(
+         "float"), "binary soft-output payload (float, double, llr8)");
+   desc.add_options()("workers,w", po::value<int>()->default_value(0),
+         "number of frames to decode in parallel (default: all threads)");
+   desc.add_options()("reorder-depth", po::value<int>()->default_value(0),
+         "frames held for in-order output (default: twice the workers)");
+   desc.add_options()("no-overlap", po::bool_switch(),
+         "do not read stream input ahead while decoding");
    po::variables_map vm;
    po::store(po::parse_command_line(argc, argv, desc), vm);
    po::notify(vm);
@@ -376,9 +779,22 @@ int main(int argc, char *argv[])
    const bool softout = vm["soft-out"].as<bool> ();
    const bool knownend = vm["known-end"].as<bool> ();
    const int count = vm["block-count"].as<int> ();
+   const std::string infile = vm.count("input-file") ? vm["input-file"].as<
+         std::string> () : "";
+   const bool binaryin = vm["binary-in"].as<bool> ();
+   output_format format;
+   format.binary = vm["binary-out"].as<bool> ();
+   format.payload = libcomm::binaryframe::payload_from_name(
+         vm["payload"].as<std::string> ());
+   const int workers = (vm["workers"].as<int> () > 0) ? vm["workers"].as<
+         int> () : libbase::getthreadcount();
+   const int depth = vm["reorder-depth"].as<int> ();
+   const bool overlap = !vm["no-overlap"].as<bool> ();
    // Check for compatibility
    if (knownend && count != 1)
       failwith("Known-end only implemented for single-block input.");
+   if (depth > 0 && depth < workers)
+      failwith("Reorder depth must be at least the number of workers.");
 
    // Main process
    if (container == "vector")
@@ -397,43 +813,56 @@ int main(int argc, char *argv[])
       using libcomm::sigspace;
       if (type == "erasable<bool>")
          process<erasable<bool>, vector> (filename, parameter, softin, softout, knownend,
-               count, blocksize);
+               count, blocksize, infile, binaryin, format, workers, depth,
+               overlap);
       else if (type == "bool")
          process<bool, vector> (filename, parameter, softin, softout, knownend,
-               count, blocksize);
+               count, blocksize, infile, binaryin, format, workers, depth,
+               overlap);
       else if (type == "gf2")
          process<gf<1, 0x3> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf4")
          process<gf<2, 0x7> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf8")
          process<gf<3, 0xB> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf16")
          process<gf<4, 0x13> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf32")
          process<gf<5, 0x25> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf64")
          process<gf<6, 0x43> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf128")
          process<gf<7, 0x89> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf256")
          process<gf<8, 0x11D> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf512")
          process<gf<9, 0x211> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf1024")
          process<gf<10, 0x409> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "sigspace")
          process<sigspace, vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -456,40 +885,52 @@ int main(int argc, char *argv[])
       using libcomm::sigspace;
       if (type == "bool")
          process<bool, matrix> (filename, parameter, softin, softout, knownend,
-               count, blocksize);
+               count, blocksize, infile, binaryin, format, workers, depth,
+               overlap);
       else if (type == "gf2")
          process<gf<1, 0x3> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf4")
          process<gf<2, 0x7> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf8")
          process<gf<3, 0xB> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf16")
          process<gf<4, 0x13> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf32")
          process<gf<5, 0x25> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf64")
          process<gf<6, 0x43> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf128")
          process<gf<7, 0x89> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf256")
          process<gf<8, 0x11D> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf512")
          process<gf<9, 0x211> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "gf1024")
          process<gf<10, 0x409> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else if (type == "sigspace")
          process<sigspace, matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, infile, binaryin, format, workers,
+               depth, overlap);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -21,15 +21,25 @@
 
 #include "serializer_libcomm.h"
 #include "commsys.h"
+#include "binaryframe.h"
 #include "cputimer.h"
 
 #include <boost/program_options.hpp>
 #include <iostream>
+#include <fstream>
 
 namespace csencode {
 
+/*!
+ * \brief   Main process
+ *
+ * Input is read from the named file if given, and from the standard input
+ * otherwise; input and output may each be text or binary frames.
+ */
+
 template <class S, template <class > class C>
-void process(const std::string& fname, std::istream& sin = std::cin,
+void process(const std::string& fname, const std::string& infile,
+      bool binaryin, bool binaryout, std::istream& sin = std::cin,
       std::ostream& sout = std::cout)
    {
    // Communication system
@@ -40,25 +50,52 @@ void process(const std::string& fname, std::istream& sin = std::cin,
    libbase::randgen r;
    r.seed(0);
    system->seedfrom(r);
+   // Set up input
+   std::ifstream file;
+   std::istream* in = &sin;
+   boost::shared_ptr<libcomm::binaryframe_reader> reader;
+   if (binaryin)
+      reader.reset(infile.empty() ? new libcomm::binaryframe_reader(sin)
+            : new libcomm::binaryframe_reader(infile));
+   else if (!infile.empty())
+      {
+      file.open(infile.c_str());
+      assertalways(file);
+      in = &file;
+      }
+   // Set up output
+   libcomm::binaryframe_writer writer(sout);
    // Repeat until end of stream
-   for (int i=0; !sin.eof(); i++)
+   for (int i = 0; reader ? !reader->eof() : !in->eof(); i++)
       {
-      // skip any comments
-      libbase::eatcomments(sin);
-      // attempt to read a block of the required size
       C<int> source(system->input_block_size());
-      source.serialize(sin);
-      // stop here if something went wrong (e.g. incomplete block)
-      if (sin.fail())
+      if (reader)
          {
-         std::cerr << "Failed to read block " << i << std::endl;
-         break;
+         // read the next frame, which must be of the required size
+         reader->read(source);
+         assertalways(source.size() == system->input_block_size());
+         }
+      else
+         {
+         // skip any comments
+         libbase::eatcomments(*in);
+         // attempt to read a block of the required size
+         source.serialize(*in);
+         // stop here if something went wrong (e.g. incomplete block)
+         if (in->fail())
+            {
+            std::cerr << "Failed to read block " << i << std::endl;
+            break;
+            }
+         // skip any trailing whitespace (before check for EOF)
+         libbase::eatwhite(*in);
          }
       // encode block and push to output stream
       C<S> transmitted = system->encode_path(source);
-      transmitted.serialize(sout, '\n');
-      // skip any trailing whitespace (before check for EOF)
-      libbase::eatwhite(sin);
+      if (binaryout)
+         writer.write(transmitted);
+      else
+         transmitted.serialize(sout, '\n');
       }
    }
 
@@ -82,6 +119,12 @@ int main(int argc, char *argv[])
          "modulation symbol type");
    desc.add_options()("container,c", po::value<std::string>()->default_value(
          "vector"), "input/output container type");
+   desc.add_options()("input-file,f", po::value<std::string>(),
+         "read input from file (default: standard input)");
+   desc.add_options()("binary-in", po::bool_switch(),
+         "read input as binary frames");
+   desc.add_options()("binary-out", po::bool_switch(),
+         "write output as binary frames");
    po::variables_map vm;
    po::store(po::parse_command_line(argc, argv, desc), vm);
    po::notify(vm);
@@ -96,6 +139,10 @@ int main(int argc, char *argv[])
    const std::string container = vm["container"].as<std::string> ();
    const std::string type = vm["type"].as<std::string> ();
    const std::string filename = vm["system-file"].as<std::string> ();
+   const std::string infile = vm.count("input-file") ? vm["input-file"].as<
+         std::string> () : "";
+   const bool binaryin = vm["binary-in"].as<bool> ();
+   const bool binaryout = vm["binary-out"].as<bool> ();
 
    // Main process
    if (container == "vector")
@@ -105,31 +152,33 @@ int main(int argc, char *argv[])
       using libbase::erasable;
       using libcomm::sigspace;
       if (type == "erasable<bool>")
-         process<erasable<bool>, vector> (filename);
+         process<erasable<bool>, vector> (filename, infile, binaryin,
+               binaryout);
       else if (type == "bool")
-         process<bool, vector> (filename);
+         process<bool, vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf2")
-         process<gf<1, 0x3> , vector> (filename);
+         process<gf<1, 0x3> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf4")
-         process<gf<2, 0x7> , vector> (filename);
+         process<gf<2, 0x7> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf8")
-         process<gf<3, 0xB> , vector> (filename);
+         process<gf<3, 0xB> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf16")
-         process<gf<4, 0x13> , vector> (filename);
+         process<gf<4, 0x13> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf32")
-         process<gf<5, 0x25> , vector> (filename);
+         process<gf<5, 0x25> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf64")
-         process<gf<6, 0x43> , vector> (filename);
+         process<gf<6, 0x43> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf128")
-         process<gf<7, 0x89> , vector> (filename);
+         process<gf<7, 0x89> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , vector> (filename);
+         process<gf<8, 0x11D> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf512")
-         process<gf<9, 0x211> , vector> (filename);
+         process<gf<9, 0x211> , vector> (filename, infile, binaryin, binaryout);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , vector> (filename);
+         process<gf<10, 0x409> , vector> (filename, infile, binaryin,
+               binaryout);
       else if (type == "sigspace")
-         process<sigspace, vector> (filename);
+         process<sigspace, vector> (filename, infile, binaryin, binaryout);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -142,29 +191,30 @@ int main(int argc, char *argv[])
       using libbase::gf;
       using libcomm::sigspace;
       if (type == "bool")
-         process<bool, matrix> (filename);
+         process<bool, matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf2")
-         process<gf<1, 0x3> , matrix> (filename);
+         process<gf<1, 0x3> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf4")
-         process<gf<2, 0x7> , matrix> (filename);
+         process<gf<2, 0x7> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf8")
-         process<gf<3, 0xB> , matrix> (filename);
+         process<gf<3, 0xB> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf16")
-         process<gf<4, 0x13> , matrix> (filename);
+         process<gf<4, 0x13> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf32")
-         process<gf<5, 0x25> , matrix> (filename);
+         process<gf<5, 0x25> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf64")
-         process<gf<6, 0x43> , matrix> (filename);
+         process<gf<6, 0x43> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf128")
-         process<gf<7, 0x89> , matrix> (filename);
+         process<gf<7, 0x89> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , matrix> (filename);
+         process<gf<8, 0x11D> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf512")
-         process<gf<9, 0x211> , matrix> (filename);
+         process<gf<9, 0x211> , matrix> (filename, infile, binaryin, binaryout);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , matrix> (filename);
+         process<gf<10, 0x409> , matrix> (filename, infile, binaryin,
+               binaryout);
       else if (type == "sigspace")
-         process<sigspace, matrix> (filename);
+         process<sigspace, matrix> (filename, infile, binaryin, binaryout);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
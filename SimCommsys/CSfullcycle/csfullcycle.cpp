@@ -22,21 +22,25 @@
 #include "serializer_libcomm.h"
 #include "commsys.h"
 #include "codec/codec_softout.h"
+#include "frame_pool.h"
 #include "cputimer.h"
+#include "walltimer.h"
 
 #include <boost/program_options.hpp>
 #include <iostream>
+#include <sstream>
 
 namespace csfullcycle {
 
+// system setup
+
 template <class S, template <class > class C>
-void process(const std::string& fname, double p, bool soft, std::istream& sin =
-      std::cin, std::ostream& sout = std::cout)
+boost::shared_ptr<libcomm::commsys<S, C> > load_system(
+      const std::string& fname, double p)
    {
    // Communication system
    boost::shared_ptr<libcomm::commsys<S, C> > system = libcomm::loadfromfile<
          libcomm::commsys<S, C> >(fname);
-   std::cerr << system->description() << std::endl;
    // Set channel parameter
    system->gettxchan()->set_parameter(p);
    system->getrxchan()->set_parameter(p);
@@ -44,40 +48,149 @@ void process(const std::string& fname, double p, bool soft, std::istream& sin =
    libbase::randgen r;
    r.seed(0);
    system->seedfrom(r);
-   // Repeat until end of stream
-   for (int j = 0; !sin.eof(); j++)
+   return system;
+   }
+
+// single-frame cycle
+
+template <class S, template <class > class C>
+void cycle(libcomm::commsys<S, C>& system, const C<int>& source, bool soft,
+      std::ostream& sout)
+   {
+   C<S> transmitted = system.encode_path(source);
+   std::cerr << ".";
+   C<S> received = system.transmit(transmitted);
+   std::cerr << ".";
+   system.receive_path(received);
+   std::cerr << ".";
+   if (soft)
       {
-      std::cerr << "Processing block " << j << ".";
-      C<int> source(system->input_block_size());
-      source.serialize(sin);
-      std::cerr << ".";
-      C<S> transmitted = system->encode_path(source);
+      libcomm::codec_softout<C>& cdc =
+            dynamic_cast<libcomm::codec_softout<C>&> (*system.getcodec());
+      C<libbase::vector<double> > ptable;
+      for (int i = 0; i < system.getcodec()->num_iter(); i++)
+         cdc.softdecode(ptable);
       std::cerr << ".";
-      C<S> received = system->transmit(transmitted);
-      std::cerr << ".";
-      system->receive_path(received);
+      ptable.serialize(sout);
+      }
+   else
+      {
+      C<int> decoded;
+      for (int i = 0; i < system.getcodec()->num_iter(); i++)
+         system.decode(decoded);
       std::cerr << ".";
-      if (soft)
+      decoded.serialize(sout, '\n');
+      }
+   }
+
+/*!
+ * \brief   Parallel cycle job
+ *
+ * Reads source frames from the input, and passes each one through the
+ * calling thread's copy of the system, for use with a libbase::frame_pool.
+ *
+ * Before encoding, the system is seeded from the frame index, so that the
+ * channel realization for each frame does not depend on which thread
+ * handles it, and is not shared between threads.
+ */
+
+template <class S, template <class > class C>
+class cycle_job {
+private:
+   std::istream& sin;
+   std::vector<boost::shared_ptr<libcomm::commsys<S, C> > >& systems;
+   const bool soft;
+   int frames;
+public:
+   cycle_job(std::istream& sin,
+         std::vector<boost::shared_ptr<libcomm::commsys<S, C> > >& systems,
+         bool soft) :
+      sin(sin), systems(systems), soft(soft), frames(0)
+      {
+      }
+   bool read(C<int>& source)
+      {
+      libbase::eatwhite(sin);
+      if (sin.eof())
+         return false;
+      source.init(systems[0]->input_block_size());
+      source.serialize(sin);
+      // stop here if something went wrong (e.g. incomplete block)
+      if (sin.fail())
          {
-         libcomm::codec_softout<C>& cdc =
-               dynamic_cast<libcomm::codec_softout<C>&> (*system->getcodec());
-         C<libbase::vector<double> > ptable;
-         for (int i = 0; i < system->getcodec()->num_iter(); i++)
-            cdc.softdecode(ptable);
-         std::cerr << ".";
-         ptable.serialize(sout);
+         std::cerr << "Failed to read block " << frames << std::endl;
+         return false;
          }
-      else
+      frames++;
+      return true;
+      }
+   void process(const int thread, const int index, const C<int>& source,
+         std::string& result)
+      {
+      libcomm::commsys<S, C>& system = *systems[thread];
+      libbase::randgen r;
+      r.seed(index);
+      system.seedfrom(r);
+      std::ostringstream s;
+      cycle(system, source, soft, s);
+      result = s.str();
+      }
+};
+
+/*!
+ * \brief   Main process
+ *
+ * Frames are processed serially with a single worker; otherwise they are
+ * processed by a pool of workers, each with its own copy of the system, and
+ * results are written in input order.
+ */
+
+template <class S, template <class > class C>
+void process(const std::string& fname, double p, bool soft, int workers,
+      int depth, std::istream& sin = std::cin, std::ostream& sout = std::cout)
+   {
+   // Communication system
+   boost::shared_ptr<libcomm::commsys<S, C> > system = load_system<S, C> (
+         fname, p);
+   std::cerr << system->description() << std::endl;
+   libbase::walltimer t("Cycle");
+   int frames = 0;
+   if (workers == 1)
+      {
+      // Repeat until end of stream
+      for (int j = 0; !sin.eof(); j++)
          {
-         C<int> decoded;
-         for (int i = 0; i < system->getcodec()->num_iter(); i++)
-            system->decode(decoded);
+         std::cerr << "Processing block " << j << ".";
+         C<int> source(system->input_block_size());
+         source.serialize(sin);
          std::cerr << ".";
-         decoded.serialize(sout, '\n');
+         cycle(*system, source, soft, sout);
+         libbase::eatwhite(sin);
+         std::cerr << "done." << std::endl;
+         frames++;
          }
-      libbase::eatwhite(sin);
-      std::cerr << "done." << std::endl;
       }
+   else
+      {
+      // Set up a copy of the system for each worker
+      std::cerr << "Processing with " << workers << " workers" << std::endl;
+      std::vector<boost::shared_ptr<libcomm::commsys<S, C> > > systems(
+            workers);
+      systems[0] = system;
+      for (int i = 1; i < workers; i++)
+         systems[i] = load_system<S, C> (fname, p);
+      cycle_job<S, C> job(sin, systems, soft);
+      libbase::frame_pool<C<int> , cycle_job<S, C> > pool(workers, depth);
+      pool.run(job, sout);
+      std::cerr << std::endl;
+      frames = pool.get_frames();
+      }
+   t.stop();
+   // Report throughput
+   std::cerr << "Processed " << frames << " frames in " << t;
+   if (t.elapsed() > 0)
+      std::cerr << " (" << frames / t.elapsed() << " frames/s)";
+   std::cerr << std::endl;
    }
 
 /*!
@@ -102,6 +215,10 @@ int main(int argc, char *argv[])
          "vector"), "input/output container type");
    desc.add_options()("parameter,r", po::value<double>(), "channel parameter");
    desc.add_options()("soft-out,s", po::bool_switch(), "enable soft output");
+   desc.add_options()("workers,w", po::value<int>()->default_value(1),
+         "number of frames to process in parallel (0 for all threads)");
+   desc.add_options()("reorder-depth", po::value<int>()->default_value(0),
+         "frames held for in-order output (default: twice the workers)");
    po::variables_map vm;
    po::store(po::parse_command_line(argc, argv, desc), vm);
    po::notify(vm);
@@ -119,6 +236,12 @@ int main(int argc, char *argv[])
    const std::string filename = vm["system-file"].as<std::string> ();
    const double parameter = vm["parameter"].as<double> ();
    const bool softout = vm["soft-out"].as<bool> ();
+   const int workers = (vm["workers"].as<int> () > 0) ? vm["workers"].as<
+         int> () : libbase::getthreadcount();
+   const int depth = vm["reorder-depth"].as<int> ();
+   // Check for compatibility
+   if (depth > 0 && depth < workers)
+      failwith("Reorder depth must be at least the number of workers.");
 
    // Main process
    if (container == "vector")
@@ -127,29 +250,41 @@ int main(int argc, char *argv[])
       using libbase::gf;
       using libcomm::sigspace;
       if (type == "bool")
-         process<bool, vector> (filename, parameter, softout);
+         process<bool, vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf2")
-         process<gf<1, 0x3> , vector> (filename, parameter, softout);
+         process<gf<1, 0x3> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf4")
-         process<gf<2, 0x7> , vector> (filename, parameter, softout);
+         process<gf<2, 0x7> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf8")
-         process<gf<3, 0xB> , vector> (filename, parameter, softout);
+         process<gf<3, 0xB> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf16")
-         process<gf<4, 0x13> , vector> (filename, parameter, softout);
+         process<gf<4, 0x13> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf32")
-         process<gf<5, 0x25> , vector> (filename, parameter, softout);
+         process<gf<5, 0x25> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf64")
-         process<gf<6, 0x43> , vector> (filename, parameter, softout);
+         process<gf<6, 0x43> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf128")
-         process<gf<7, 0x89> , vector> (filename, parameter, softout);
+         process<gf<7, 0x89> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , vector> (filename, parameter, softout);
+         process<gf<8, 0x11D> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf512")
-         process<gf<9, 0x211> , vector> (filename, parameter, softout);
+         process<gf<9, 0x211> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , vector> (filename, parameter, softout);
+         process<gf<10, 0x409> , vector> (filename, parameter, softout, workers,
+               depth);
       else if (type == "sigspace")
-         process<sigspace, vector> (filename, parameter, softout);
+         process<sigspace, vector> (filename, parameter, softout, workers,
+               depth);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -162,29 +297,41 @@ int main(int argc, char *argv[])
       using libbase::gf;
       using libcomm::sigspace;
       if (type == "bool")
-         process<bool, matrix> (filename, parameter, softout);
+         process<bool, matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf2")
-         process<gf<1, 0x3> , matrix> (filename, parameter, softout);
+         process<gf<1, 0x3> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf4")
-         process<gf<2, 0x7> , matrix> (filename, parameter, softout);
+         process<gf<2, 0x7> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf8")
-         process<gf<3, 0xB> , matrix> (filename, parameter, softout);
+         process<gf<3, 0xB> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf16")
-         process<gf<4, 0x13> , matrix> (filename, parameter, softout);
+         process<gf<4, 0x13> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf32")
-         process<gf<5, 0x25> , matrix> (filename, parameter, softout);
+         process<gf<5, 0x25> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf64")
-         process<gf<6, 0x43> , matrix> (filename, parameter, softout);
+         process<gf<6, 0x43> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf128")
-         process<gf<7, 0x89> , matrix> (filename, parameter, softout);
+         process<gf<7, 0x89> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , matrix> (filename, parameter, softout);
+         process<gf<8, 0x11D> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf512")
-         process<gf<9, 0x211> , matrix> (filename, parameter, softout);
+         process<gf<9, 0x211> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , matrix> (filename, parameter, softout);
+         process<gf<10, 0x409> , matrix> (filename, parameter, softout, workers,
+               depth);
       else if (type == "sigspace")
-         process<sigspace, matrix> (filename, parameter, softout);
+         process<sigspace, matrix> (filename, parameter, softout, workers,
+               depth);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
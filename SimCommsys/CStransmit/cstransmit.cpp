@@ -21,16 +21,27 @@
 
 #include "serializer_libcomm.h"
 #include "commsys.h"
+#include "binaryframe.h"
 #include "cputimer.h"
 
 #include <boost/program_options.hpp>
 #include <iostream>
+#include <fstream>
 
 namespace cstransmit {
 
+/*!
+ * \brief   Main process
+ *
+ * Input is read from the named file if given, and from the standard input
+ * otherwise; input and output may each be text or binary frames, with
+ * signal-space points in binary output written with the given payload.
+ */
+
 template <class S, template <class > class C>
-void process(const std::string& fname, double p, std::istream& sin = std::cin,
-      std::ostream& sout = std::cout)
+void process(const std::string& fname, double p, const std::string& infile,
+      bool binaryin, bool binaryout, libcomm::binaryframe::payload_t payload,
+      std::istream& sin = std::cin, std::ostream& sout = std::cout)
    {
    // Communication system
    boost::shared_ptr<libcomm::commsys<S, C> > system = libcomm::loadfromfile<
@@ -42,14 +53,40 @@ void process(const std::string& fname, double p, std::istream& sin = std::cin,
    libbase::randgen r;
    r.seed(0);
    system->seedfrom(r);
+   // Set up input
+   std::ifstream file;
+   std::istream* in = &sin;
+   boost::shared_ptr<libcomm::binaryframe_reader> reader;
+   if (binaryin)
+      reader.reset(infile.empty() ? new libcomm::binaryframe_reader(sin)
+            : new libcomm::binaryframe_reader(infile));
+   else if (!infile.empty())
+      {
+      file.open(infile.c_str());
+      assertalways(file);
+      in = &file;
+      }
+   // Set up output
+   libcomm::binaryframe_writer writer(sout, payload);
    // Repeat until end of stream
-   while (!sin.eof())
+   while (reader ? !reader->eof() : !in->eof())
       {
       C<S> transmitted(system->output_block_size());
-      transmitted.serialize(sin);
+      if (reader)
+         {
+         reader->read(transmitted);
+         assertalways(transmitted.size() == system->output_block_size());
+         }
+      else
+         {
+         transmitted.serialize(*in);
+         libbase::eatwhite(*in);
+         }
       C<S> received = system->transmit(transmitted);
-      received.serialize(sout, '\n');
-      libbase::eatwhite(sin);
+      if (binaryout)
+         writer.write(received);
+      else
+         received.serialize(sout, '\n');
       }
    }
 
@@ -74,6 +111,14 @@ int main(int argc, char *argv[])
    desc.add_options()("container,c", po::value<std::string>()->default_value(
          "vector"), "input/output container type");
    desc.add_options()("parameter,r", po::value<double>(), "channel parameter");
+   desc.add_options()("input-file,f", po::value<std::string>(),
+         "read input from file (default: standard input)");
+   desc.add_options()("binary-in", po::bool_switch(),
+         "read input as binary frames");
+   desc.add_options()("binary-out", po::bool_switch(),
+         "write output as binary frames");
+   desc.add_options()("payload", po::value<std::string>()->default_value(
+         "double"), "binary signal-space payload (float, double)");
    po::variables_map vm;
    po::store(po::parse_command_line(argc, argv, desc), vm);
    po::notify(vm);
@@ -90,6 +135,13 @@ int main(int argc, char *argv[])
    const std::string type = vm["type"].as<std::string> ();
    const std::string filename = vm["system-file"].as<std::string> ();
    const double parameter = vm["parameter"].as<double> ();
+   const std::string infile = vm.count("input-file") ? vm["input-file"].as<
+         std::string> () : "";
+   const bool binaryin = vm["binary-in"].as<bool> ();
+   const bool binaryout = vm["binary-out"].as<bool> ();
+   const libcomm::binaryframe::payload_t payload =
+         libcomm::binaryframe::payload_from_name(
+               vm["payload"].as<std::string> ());
 
    // Main process
    if (container == "vector")
@@ -98,29 +150,41 @@ int main(int argc, char *argv[])
       using libbase::gf;
       using libcomm::sigspace;
       if (type == "bool")
-         process<bool, vector> (filename, parameter);
+         process<bool, vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf2")
-         process<gf<1, 0x3> , vector> (filename, parameter);
+         process<gf<1, 0x3> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf4")
-         process<gf<2, 0x7> , vector> (filename, parameter);
+         process<gf<2, 0x7> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf8")
-         process<gf<3, 0xB> , vector> (filename, parameter);
+         process<gf<3, 0xB> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf16")
-         process<gf<4, 0x13> , vector> (filename, parameter);
+         process<gf<4, 0x13> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf32")
-         process<gf<5, 0x25> , vector> (filename, parameter);
+         process<gf<5, 0x25> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf64")
-         process<gf<6, 0x43> , vector> (filename, parameter);
+         process<gf<6, 0x43> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf128")
-         process<gf<7, 0x89> , vector> (filename, parameter);
+         process<gf<7, 0x89> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , vector> (filename, parameter);
+         process<gf<8, 0x11D> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf512")
-         process<gf<9, 0x211> , vector> (filename, parameter);
+         process<gf<9, 0x211> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , vector> (filename, parameter);
+         process<gf<10, 0x409> , vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "sigspace")
-         process<sigspace, vector> (filename, parameter);
+         process<sigspace, vector> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -133,29 +197,41 @@ int main(int argc, char *argv[])
       using libbase::gf;
       using libcomm::sigspace;
       if (type == "bool")
-         process<bool, matrix> (filename, parameter);
+         process<bool, matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf2")
-         process<gf<1, 0x3> , matrix> (filename, parameter);
+         process<gf<1, 0x3> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf4")
-         process<gf<2, 0x7> , matrix> (filename, parameter);
+         process<gf<2, 0x7> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf8")
-         process<gf<3, 0xB> , matrix> (filename, parameter);
+         process<gf<3, 0xB> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf16")
-         process<gf<4, 0x13> , matrix> (filename, parameter);
+         process<gf<4, 0x13> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf32")
-         process<gf<5, 0x25> , matrix> (filename, parameter);
+         process<gf<5, 0x25> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf64")
-         process<gf<6, 0x43> , matrix> (filename, parameter);
+         process<gf<6, 0x43> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf128")
-         process<gf<7, 0x89> , matrix> (filename, parameter);
+         process<gf<7, 0x89> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , matrix> (filename, parameter);
+         process<gf<8, 0x11D> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf512")
-         process<gf<9, 0x211> , matrix> (filename, parameter);
+         process<gf<9, 0x211> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , matrix> (filename, parameter);
+         process<gf<10, 0x409> , matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else if (type == "sigspace")
-         process<sigspace, matrix> (filename, parameter);
+         process<sigspace, matrix> (filename, parameter, infile, binaryin,
+               binaryout, payload);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
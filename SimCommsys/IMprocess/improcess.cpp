@@ -20,14 +20,20 @@
  */
 
 #include "image.h"
+#include "imagefile.h"
 #include "cputimer.h"
 #include "filter/limitfilter.h"
+#include "filter/atmfilter.h"
+#include "filter/awfilter.h"
+#include "filter/variancefilter.h"
 
 #include <boost/program_options.hpp>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <typeinfo>
+#include <vector>
+#include <algorithm>
 
 namespace improcess {
 
@@ -79,6 +85,95 @@ void subsample(const int xoff, const int xinc, const int yoff, const int yinc,
    image_out.serialize(sout);
    }
 
+/*!
+ * \brief   Image sub-sampling process, on image files
+ * \author  Johann Briffa
+ *
+ * The input is read a band of rows at a time, so that only the band and
+ * the corresponding output rows are held in memory.
+ */
+
+template <class S>
+void subsample(const int xoff, const int xinc, const int yoff, const int yinc,
+      const int band, const std::string& infile, const std::string& outfile)
+   {
+   libimage::imagefile fin;
+   fin.open(infile);
+   // Tell use what we're doing
+   std::cerr << "Subsampling: " << xoff << ',' << xinc << ',' << yoff << ','
+         << yinc << " (in bands of " << band << " rows)" << std::endl;
+   // Determine size of resulting image
+   const int rows = (fin.rows() - yoff + (yinc - 1)) / yinc;
+   const int cols = (fin.cols() - xoff + (xinc - 1)) / xinc;
+   // Create output image
+   libimage::imagefile fout;
+   fout.create(outfile, rows, cols, fin.channels(), fin.range());
+   // Process in bands of input rows
+   for (int r0 = 0; r0 < fin.rows(); r0 += band)
+      {
+      const int r1 = std::min(fin.rows(), r0 + band);
+      // output rows coming from this band
+      const int ii0 = (std::max(r0, yoff) - yoff + (yinc - 1)) / yinc;
+      const int ii1 = (std::max(r1, yoff) - yoff + (yinc - 1)) / yinc;
+      if (ii1 <= ii0)
+         continue;
+      for (int c = 0; c < fin.channels(); c++)
+         {
+         libbase::matrix<S> a;
+         fin.read(r0, r1, c, a);
+         libbase::matrix<S> b(ii1 - ii0, cols);
+         for (int ii = ii0; ii < ii1; ii++)
+            for (int j = xoff, jj = 0; j < fin.cols(); j += xinc, jj++)
+               b(ii - ii0, jj) = a(yoff + ii * yinc - r0, j);
+         fout.write(ii0, c, b);
+         }
+      }
+   }
+
+/*!
+ * \brief   Neighbourhood filtering process, on image files
+ * \author  Johann Briffa
+ *
+ * Filter specification is one of:
+ * - atm,d,alpha : alpha-trimmed mean over distance d
+ * - aw,d[,noise] : adaptive Wiener filter over distance d
+ * - variance,d : local variance over distance d
+ */
+
+template <class S>
+void neighbourhood(const std::string& spec, const int band,
+      const std::string& infile, const std::string& outfile)
+   {
+   libimage::imagefile fin;
+   fin.open(infile);
+   libimage::imagefile fout;
+   fout.create(outfile, fin.rows(), fin.cols(), fin.channels(), fin.range());
+   // Interpret filter specification
+   std::istringstream ssin(spec);
+   std::string name;
+   std::getline(ssin, name, ',');
+   std::vector<double> par;
+   double x;
+   while (ssin >> x)
+      {
+      par.push_back(x);
+      char c;
+      ssin >> c;
+      }
+   std::cerr << "Filtering: " << spec << " (in bands of " << band
+         << " rows)" << std::endl;
+   if (name == "atm" && par.size() == 2)
+      libimage::atmfilter<S>(int(par[0]), int(par[1])).apply(fin, fout, band);
+   else if (name == "aw" && par.size() == 1)
+      libimage::awfilter<S>(int(par[0])).apply(fin, fout, band);
+   else if (name == "aw" && par.size() == 2)
+      libimage::awfilter<S>(int(par[0]), par[1]).apply(fin, fout, band);
+   else if (name == "variance" && par.size() == 1)
+      libimage::variancefilter<S>(int(par[0])).apply(fin, fout, band);
+   else
+      failwith("Unrecognized filter specification");
+   }
+
 // Rounding
 
 template <class real>
@@ -275,19 +370,73 @@ int main(int argc, char *argv[])
    desc.add_options()("resample", po::value<std::string>(),
          "resampling pattern (xoff,yoff,scale,limit)");
    desc.add_options()("safescale", "auto-scales contrast by a power of 2");
+   desc.add_options()("filter", po::value<std::string>(),
+         "neighbourhood filter (atm,d,alpha | aw,d[,noise] | variance,d); "
+            "needs input and output files");
+   desc.add_options()("band", po::value<int>()->default_value(0),
+         "process image files in bands of this many rows (0 to load whole image)");
    po::variables_map vm;
    po::store(po::parse_command_line(argc, argv, desc), vm);
    po::notify(vm);
 
    // Validate user parameters
    if (vm.count("help") || (vm.count("subsample") + vm.count("resample")
-         + vm.count("safescale")) != 1)
+         + vm.count("safescale") + vm.count("filter")) != 1)
       {
       std::cerr << desc << std::endl;
       return 1;
       }
    // Shorthand access for parameters
    const std::string type = vm["type"].as<std::string> ();
+   const bool files = vm.count("input") > 0 && vm.count("output") > 0;
+   const int band = vm["band"].as<int> ();
+   if (vm.count("filter") == 1)
+      {
+      if (!files)
+         {
+         std::cerr << "Filtering needs input and output files" << std::endl;
+         return 1;
+         }
+      const std::string spec = vm["filter"].as<std::string> ();
+      const std::string infile = vm["input"].as<std::string> ();
+      const std::string outfile = vm["output"].as<std::string> ();
+      // whole image when no band size is given
+      const int rows = (band > 0) ? band : 1 << 30;
+      if (type == "int")
+         neighbourhood<int> (spec, rows, infile, outfile);
+      else if (type == "float")
+         neighbourhood<float> (spec, rows, infile, outfile);
+      else if (type == "double")
+         neighbourhood<double> (spec, rows, infile, outfile);
+      else
+         {
+         std::cerr << "Unrecognized pixel type: " << type << std::endl;
+         return 1;
+         }
+      return 0;
+      }
+   if (vm.count("subsample") == 1 && files && band > 0)
+      {
+      const std::string parameters = vm["subsample"].as<std::string> ();
+      std::istringstream ssin(parameters);
+      char c;
+      int xoff, xinc, yoff, yinc;
+      ssin >> xoff >> c >> xinc >> c >> yoff >> c >> yinc;
+      const std::string infile = vm["input"].as<std::string> ();
+      const std::string outfile = vm["output"].as<std::string> ();
+      if (type == "int")
+         subsample<int> (xoff, xinc, yoff, yinc, band, infile, outfile);
+      else if (type == "float")
+         subsample<float> (xoff, xinc, yoff, yinc, band, infile, outfile);
+      else if (type == "double")
+         subsample<double> (xoff, xinc, yoff, yinc, band, infile, outfile);
+      else
+         {
+         std::cerr << "Unrecognized pixel type: " << type << std::endl;
+         return 1;
+         }
+      return 0;
+      }
    // Interpret input/output filenames
    std::fstream fin, fout;
    if (vm.count("input") > 0)
@@ -21,11 +21,14 @@
 
 #include "pacifier.h"
 #include "cputimer.h"
+#include "walltimer.h"
 #include "randgen.h"
 #include "truerand.h"
 
 #include <boost/program_options.hpp>
 #include <vector>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -64,73 +67,143 @@ public:
       }
 };
 
-template <class T>
-class mylist;
-
-template <class T>
-class pair {
-public:
-   T value;
-   typename mylist<T>::iterator index;
-};
-
 /*!
- * \brief Container for S-Random interleaver creation
- * The base container must have the following abilities:
- * - removing an element from the middle with erase()
- * - return number of elements with size()
- * - return true when empty with empty()
- * This container has the following additional abilities:
- * - initializing with numerical sequence
- * - random-access iterator return
+ * \brief Working state for filling an S-Random interleaver
+ *
+ * The spread criterion requires that any two entries at most 'spread'
+ * positions apart differ in value by at least 'spread'. When filling
+ * position i, the values forbidden by the previous 'spread' entries are
+ * tracked incrementally: each entry in this window blocks the values within
+ * distance spread-1 of its own, and the count of blocking entries is kept
+ * for every value. Unused values are kept in an array with an index of
+ * their locations, so that a value is removed in constant time.
  */
-template <class T>
-class mylist : public std::vector<T> {
+class srandom_fill {
 private:
-   typedef std::vector<T> Base;
-public:
-   mylist(const int x = 0) :
-      Base(x)
+   const int tau; //!< Interleaver length
+   const int spread; //!< Spread to achieve
+   myvector<int>& lut; //!< Interleaver being filled
+   std::vector<int> unused; //!< Values not yet used
+   std::vector<int> where; //!< Location of each value in 'unused'
+   std::vector<int> blocked; //!< Number of window entries blocking each value
+   libbase::randgen prng; //!< Generator for this attempt
+private:
+   //! Update block counts for values near 'n'
+   void mark(const int n, const int delta)
       {
+      const int lo = std::max(0, n - spread + 1);
+      const int hi = std::min(tau - 1, n + spread - 1);
+      for (int v = lo; v <= hi; v++)
+         blocked[v] += delta;
       }
-   typename Base::iterator getiteratorat(const int x)
+   //! Remove value 'n' from the list of unused values
+   void use(const int n)
       {
-      typename Base::iterator it = Base::begin();
-      for (int i = 0; i < x; i++)
-         it++;
-      return it;
+      const int k = where[n];
+      const int last = unused.back();
+      unused[k] = last;
+      where[last] = k;
+      unused.pop_back();
       }
-   void sequence()
+   /*! \brief Check the spread criterion for value 'n' at position 'j'
+    * Only positions before 'i' are considered, excluding 'skip'.
+    */
+   bool fits(const int n, const int j, const int i, const int skip) const
       {
-      typename Base::iterator it;
-      int i = 0;
-      for (it = Base::begin(); it != Base::end(); it++)
-         *it = i++;
+      const int lo = std::max(0, j - spread);
+      const int hi = std::min(i - 1, j + spread);
+      for (int p = lo; p <= hi; p++)
+         if (p != j && p != skip && abs(lut(p) - n) < spread)
+            return false;
+      return true;
       }
-   mylist<pair<T> > pairup()
+   /*! \brief Repair a dead end at position 'i' by swapping
+    * An unused value 'v' is placed at some earlier position j (where it fits),
+    * and the value 'u' displaced from there is placed at i (where it must
+    * fit too, given 'v' at j).
+    */
+   bool repair(const int i)
       {
-      mylist<pair<T> > result(Base::size());
-      typename Base::iterator thisit;
-      typename mylist<pair<T> >::iterator pairit = result.begin();
-      for (thisit = Base::begin(); thisit != Base::end(); thisit++)
+      const int tries = std::max(tau, 64);
+      for (int t = 0; t < tries; t++)
          {
-         pairit->value = *thisit;
-         pairit->index = thisit;
-         pairit++;
+         const int v = unused[prng.ival(unused.size())];
+         const int j = prng.ival(i);
+         const int u = lut(j);
+         if (!fits(v, j, i, -1) || !fits(u, i, i, j))
+            continue;
+         if (j >= i - spread && abs(u - v) < spread)
+            continue;
+         // swap, keeping the block counts for the window up to date
+         if (j >= i - spread)
+            {
+            mark(u, -1);
+            mark(v, +1);
+            }
+         lut(j) = v;
+         lut(i) = u;
+         use(v);
+         mark(u, +1);
+         return true;
+         }
+      return false;
+      }
+public:
+   srandom_fill(myvector<int>& lut, const int tau, const int spread,
+         const libbase::int32u seed) :
+      tau(tau), spread(spread), lut(lut), unused(tau), where(tau), blocked(
+            tau, 0)
+      {
+      for (int n = 0; n < tau; n++)
+         unused[n] = where[n] = n;
+      prng.seed(seed);
+      }
+   /*! \brief Fill the interleaver
+    * \return Number of positions filled (equal to tau on success)
+    */
+   int fill()
+      {
+      for (int i = 0; i < tau; i++)
+         {
+         // the entry leaving the window no longer blocks any values
+         if (i > spread)
+            mark(lut(i - spread - 1), -1);
+         // look for an allowed value, from a random starting point
+         const int remaining = unused.size();
+         const int start = prng.ival(remaining);
+         int n = -1;
+         for (int k = 0; k < remaining && n < 0; k++)
+            {
+            const int v = unused[(start + k) % remaining];
+            if (blocked[v] == 0)
+               n = v;
+            }
+         if (n >= 0)
+            {
+            lut(i) = n;
+            use(n);
+            mark(n, +1);
+            }
+         else if (i == 0 || !repair(i))
+            return i;
          }
-      return result;
+      return tau;
       }
 };
 
-//! Check if the last element inserted satisfies the spread criterion
+//! Determine the spread actually achieved by the given interleaver
 
-bool satisfiesspread(const myvector<int>& lut, const int n, const int i,
-      const int spread)
+int achieved_spread(const myvector<int>& lut)
    {
-   for (int j = std::max(0, i - spread); j < i; j++)
-      if (abs(lut(j) - n) < spread)
-         return false;
-   return true;
+   const int tau = lut.size();
+   // the spread is the largest S such that any entries up to S positions
+   // apart differ by at least S; entries d apart differing by x rule out
+   // any S >= max(d, x+1)
+   int bound = tau + 1;
+   for (int d = 1; d < bound && d < tau; d++)
+      for (int i = 0; i + d < tau; i++)
+         bound = std::min(bound, std::max(d, abs(lut(i) - lut(i + d)) + 1));
+   return bound - 1;
    }
 
 //! S-Random creation process
@@ -144,55 +217,49 @@ myvector<int> create_srandom(const int tau, int& spread, libbase::int32u& seed,
    libbase::truerand trng;
    libbase::randgen seeder;
    seeder.seed(trng.ival());
-   libbase::randgen prng;
    // initialize space for results
    myvector<int> lut(tau);
 
-   bool failed = true;
-   while (failed)
+   bool found = false;
+   while (!found)
       {
       std::cerr << "Searching for solution at spread " << spread << std::endl;
       // loop for a number of attempts at the given Spread, then
-      // reduce and continue as necessary
-      libbase::cputimer tmain("Attempt timer");
-      int attempt;
-      for (attempt = 0; attempt < max_attempts && failed; attempt++)
+      // reduce and continue as necessary; independent attempts are made in
+      // parallel, each with its own seed, so the result is reproducible
+      // from the seed alone
+      libbase::walltimer tmain("Attempt timer");
+      int attempt = 0;
+      int best = 0;
+#pragma omp parallel
          {
-         std::cerr << p.update(attempt, max_attempts);
-         // re-seed random generator
-         seed = seeder.ival();
-         prng.seed(seed);
-         // set up working variables
-         mylist<int> unused(tau);
-         unused.sequence();
-         // loop to fill all entries in the interleaver - or until we fail
-         failed = false;
-         for (int i = 0; i < tau && !failed; i++)
+         myvector<int> trial(tau);
+         while (true)
             {
-            // set up for the current entry
-            mylist<pair<int> > untried = unused.pairup();
-            // loop for the current entry
-            // until we find a suitable value or totally fail trying
-            while (!failed)
+            libbase::int32u trialseed = 0;
+            bool stop;
+#pragma omp critical(makesrandom_attempt)
                {
-               // choose a random number from what's left to try
-               mylist<pair<int> >::iterator ndx = untried.getiteratorat(
-                     prng.ival(untried.size()));
-               const int n = ndx->value;
-               // if it's no good remove it from the list of options
-               if (!satisfiesspread(lut, n, i, spread))
+               stop = found || attempt >= max_attempts;
+               if (!stop)
                   {
-                  untried.erase(ndx);
-                  failed = untried.empty();
-                  continue;
+                  trialseed = seeder.ival();
+                  attempt++;
                   }
-               // if it's a suitable value, insert & mark as used
-               else
+               }
+            if (stop)
+               break;
+            const int filled = srandom_fill(trial, tau, spread, trialseed).fill();
+#pragma omp critical(makesrandom_attempt)
+               {
+               best = std::max(best, filled);
+               if (filled == tau && !found)
                   {
-                  unused.erase(ndx->index);
-                  lut(i) = n;
-                  break;
+                  found = true;
+                  lut = trial;
+                  seed = trialseed;
                   }
+               std::cerr << p.update(attempt, max_attempts);
                }
             }
          }
@@ -201,13 +268,16 @@ myvector<int> create_srandom(const int tau, int& spread, libbase::int32u& seed,
       std::cerr << "Attempts: " << attempt << " in " << tmain << std::endl;
       std::cerr << "Speed: " << double(attempt) / tmain.elapsed()
             << " attempts/sec" << std::endl;
+      std::cerr << "Best: " << best << " of " << tau << " positions filled"
+            << std::endl;
       // if this failed, prepare for the next attempt
-      if (failed)
+      if (!found)
          spread--;
       }
 
    // stop timers
    std::cerr << p.update(max_attempts, max_attempts);
+   std::cerr << "Achieved spread: " << achieved_spread(lut) << std::endl;
 
    return lut;
    }
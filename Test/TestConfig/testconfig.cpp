@@ -22,6 +22,9 @@
 #include "config.h"
 #include "matrix.h"
 #include "multi_array.h"
+#include "circular_buffer.h"
+#include "levenshtein.h"
+#include "packedvector.h"
 
 #include <boost/lambda/lambda.hpp>
 #include <iterator>
@@ -221,6 +224,85 @@ void testvector()
    accessvectorbyvalue(r);
    }
 
+void testcircularbuffer()
+   {
+   cout << std::endl << "Circular Buffer:" << std::endl << std::endl;
+   libbase::circular_buffer<int> b;
+   // append and consume blocks, keeping a tail across each step
+   int next = 0;
+   for (int i = 0; i < 10; i++)
+      {
+      vector<int> x(7);
+      for (int j = 0; j < x.size(); j++)
+         x(j) = next++;
+      b.push_back(x);
+      b.pop_front(b.size() - 3);
+      }
+   // contents should be the last three elements, as a contiguous view
+   vector<int> r = b.segment(0, b.size());
+   cout << "Capacity: " << b.capacity() << std::endl;
+   cout << "Contents: {";
+   r.serialize(cout, ',');
+   cout << "}" << std::endl;
+   assert(r.size() == 3);
+   for (int j = 0; j < r.size(); j++)
+      assert(r(j) == next - 3 + j);
+   }
+
+void testlevenshtein()
+   {
+   cout << std::endl << "Levenshtein Distance:" << std::endl << std::endl;
+   // sequences spanning more than one word, with a few substitutions,
+   // insertions and deletions
+   const int n = 150;
+   vector<int> s(n), t(n);
+   for (int i = 0; i < n; i++)
+      s(i) = (i * 7 + i / 5) % 3;
+   t = s;
+   t(10) = (t(10) + 1) % 3;
+   t(100) = (t(100) + 1) % 3;
+   // delete s(40) and insert a symbol before s(70)
+   for (int i = 40; i < 69; i++)
+      t(i) = s(i + 1);
+   t(69) = 2;
+   // reference distance by direct dynamic programming
+   matrix<int> d(n + 1, n + 1);
+   for (int i = 0; i <= n; i++)
+      d(i, 0) = d(0, i) = i;
+   for (int j = 0; j < n; j++)
+      for (int i = 0; i < n; i++)
+         d(i + 1, j + 1) = std::min(std::min(d(i, j + 1) + 1, d(i + 1, j)
+               + 1), d(i, j) + (s(i) == t(j) ? 0 : 1));
+   const int ld = libbase::levenshtein(s, t);
+   const int lb = libbase::levenshtein(s, t, 2);
+   cout << "Reference: " << d(n, n) << std::endl;
+   cout << "Bit-vector: " << ld << std::endl;
+   cout << "Banded: " << lb << std::endl;
+   assert(ld == d(n, n));
+   assert(lb == d(n, n));
+   }
+
+void testpackedvector()
+   {
+   cout << std::endl << "Packed Vector:" << std::endl << std::endl;
+   // a sparse histogram of counts, with a few non-integer values
+   vector<double> x(1000);
+   x = 0;
+   for (int i = 0; i < x.size(); i += 17)
+      x(i) = 1000 + i % 7;
+   x(1) = -3;
+   x(2) = 0.25;
+   x(3) = 1e300;
+   const std::string s = libbase::pack(x);
+   vector<double> y;
+   libbase::unpack(s, y);
+   cout << "Raw size: " << x.size() * sizeof(double) << std::endl;
+   cout << "Packed size: " << s.size() << std::endl;
+   assert(y.size() == x.size());
+   for (int i = 0; i < x.size(); i++)
+      assert(y(i) == x(i));
+   }
+
 void testmatrixmul()
    {
    cout << std::endl << "Matrix Multiplication:" << std::endl << std::endl;
@@ -416,6 +498,9 @@ int main(int argc, char *argv[])
    print_struct_sizes();
    print_vector_sizes();
    testvector();
+   testcircularbuffer();
+   testlevenshtein();
+   testpackedvector();
    testmatrixmul();
    testmatrixinv();
    testmatrixops();
@@ -21,6 +21,7 @@
 
 #include "gf.h"
 #include "gf_fast.h"
+#include "gf_region.h"
 #include "bitfield.h"
 #include "matrix.h"
 #include "cputimer.h"
@@ -30,6 +31,8 @@ namespace testgf {
 
 using libbase::gf;
 using libbase::gf_fast;
+using libbase::gf_region;
+using libbase::vector;
 using libbase::bitfield;
 using libbase::matrix;
 using libbase::cputimer;
@@ -129,6 +132,48 @@ void TestMulDiv()
       }
    }
 
+template <int m, int poly>
+void TestRegion()
+   {
+   typedef gf<m, poly> GF_q;
+   // Compare region products with element-by-element computation
+   cout << std::endl << "GF(" << m << ",0x" << hex << poly << dec
+         << ") region operations:" << std::endl;
+   const int rows = 7;
+   const int cols = 29;
+   matrix<GF_q> A(rows, cols);
+   vector<GF_q> x(rows), z(cols), y;
+   for (int i = 0; i < rows; i++)
+      {
+      x(i) = (3 * i + 1) % GF_q::elements();
+      for (int j = 0; j < cols; j++)
+         A(i, j) = (i * cols + j) % GF_q::elements();
+      }
+   for (int j = 0; j < cols; j++)
+      z(j) = (5 * j + 2) % GF_q::elements();
+   int errors = 0;
+   gf_region<GF_q>::multiply(x, A, y);
+   for (int j = 0; j < cols; j++)
+      {
+      GF_q s = 0;
+      for (int i = 0; i < rows; i++)
+         s += x(i) * A(i, j);
+      if (s != y(j))
+         errors++;
+      }
+   gf_region<GF_q>::multiply(A, z, y);
+   for (int i = 0; i < rows; i++)
+      {
+      GF_q s = 0;
+      for (int j = 0; j < cols; j++)
+         s += A(i, j) * z(j);
+      if (s != y(i))
+         errors++;
+      }
+   cout << "Errors: " << errors << std::endl;
+   assertalways(errors == 0);
+   }
+
 void TestGenPowerGF2()
    {
    cout << std::endl << "Binary generator matrix power sequence:" << std::endl;
@@ -1351,6 +1396,10 @@ int main(int argc, char *argv[])
    ListField<3, 0xB> ();
    ListField<4, 0x13> ();
    TestMulDiv<3, 0xB> ();
+   TestRegion<3, 0xB> ();
+   TestRegion<8, 0x11D> ();
+   TestRegion<8, 0x11B> ();
+   TestRegion<10, 0x409> ();
    TestGenPowerGF2();
    TestGenPowerGF8();
    // TODO: templatize tests for gf_fast
@@ -20,6 +20,7 @@
  */
 
 #include "serializer_libcomm.h"
+#include "gf2_matrix.h"
 #include "cputimer.h"
 
 #include <boost/program_options.hpp>
@@ -40,6 +41,54 @@ C<int> createsource(libbase::random& r, const boost::shared_ptr<libcomm::codec<C
    return source;
    }
 
+template <template <class > class C>
+void check_binary(libbase::random& r, const boost::shared_ptr<
+      libcomm::codec<C, double> > cdc, int count)
+   {
+   // only implemented for vector containers
+   }
+
+/*!
+ * \brief Verify that codewords of a binary code lie in the space spanned by
+ * the encoded unit vectors
+ *
+ * The encoded unit vectors form a generator matrix; its null space gives a
+ * parity-check matrix, which must give a zero syndrome for all codewords.
+ */
+void check_binary(libbase::random& r, const boost::shared_ptr<
+      libcomm::codec<libbase::vector, double> > cdc, int count)
+   {
+   if (cdc->num_inputs() != 2 || cdc->num_outputs() != 2)
+      return;
+   const int k = cdc->input_block_size();
+   const int n = cdc->output_block_size();
+   // Determine generator matrix
+   libbase::gf2_matrix G(k, n);
+   for (int i = 0; i < k; i++)
+      {
+      libbase::vector<int> source(k);
+      source = 0;
+      source(i) = 1;
+      libbase::vector<int> encoded;
+      cdc->encode(source, encoded);
+      for (int j = 0; j < n; j++)
+         G.set(i, j, encoded(j) != 0);
+      }
+   // Determine parity-check matrix
+   const libbase::gf2_matrix H = G.null_space();
+   std::cerr << "Binary code: dimension " << n - H.rows() << std::endl;
+   // Check syndrome of random codewords
+   for (int i = 0; i < count; i++)
+      {
+      libbase::vector<int> source = createsource(r, cdc);
+      libbase::vector<int> encoded;
+      cdc->encode(source, encoded);
+      libbase::vector<int> syndrome;
+      H.multiply(encoded, syndrome);
+      assertalways(syndrome.max() == 0);
+      }
+   }
+
 template <class S, template <class > class C>
 void process(const std::string& fname, int count)
    {
@@ -70,6 +119,8 @@ void process(const std::string& fname, int count)
       C<int> encodedS = C<int> (C<S> (encoded1) + C<S> (encoded2));
       assertalways(encodedS.isequalto(encoded3));
       }
+   // For binary codes, also check against the code's parity-check matrix
+   check_binary(r, cdc, count);
    }
 
 /*!